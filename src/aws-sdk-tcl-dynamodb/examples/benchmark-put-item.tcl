@@ -0,0 +1,50 @@
+package require awsdynamodb
+
+# Measures put_item of a wide item, e.g. to compare two builds of the
+# extension. Usage: tclsh benchmark-put-item.tcl ?attributes? ?iterations? ?endpoint?
+lassign $argv attributes iterations endpoint
+if { $attributes eq "" } { set attributes 2000 }
+if { $iterations eq "" } { set iterations 200 }
+
+# To use it with localstack, you can use the following configuration.
+# With an endpoint where nothing listens, e.g. http://127.0.0.1:9, every
+# put_item fails right after the item has been converted and the request
+# serialized and signed, which measures the client side alone.
+if { $endpoint eq "" } { set endpoint "http://localhost:4566" }
+set config_dict [dict create region us-east-1 endpoint $endpoint maxAttempts 1]
+
+set table "BenchmarkTable"
+
+# creates a DynamoDB client
+::aws::dynamodb::create $config_dict client
+
+catch { $client create_table $table [dict create id [list N HASH]] }
+
+# an item with "attributes" top-level attributes, half strings and half
+# numbers, and a map and a list with as many nested values
+set item_dict [dict create id [list N 1]]
+set map_list [list]
+set list_list [list]
+for { set i 0 } { $i < $attributes } { incr i } {
+    if { $i % 2 } {
+        dict set item_dict attr$i [list S "value of attribute $i"]
+    } else {
+        dict set item_dict attr$i [list N $i]
+    }
+    lappend map_list key$i [list S "nested value $i"]
+    lappend list_list [list N $i]
+}
+dict set item_dict nested_map [list M $map_list]
+dict set item_dict nested_list [list L $list_list]
+
+# warm up, e.g. the connection pool
+catch { $client put_item $table $item_dict }
+
+set errors 0
+set usec [lindex [time {
+    if { [catch { $client put_item $table $item_dict }] } {
+        incr errors
+    }
+} $iterations] 0]
+
+puts "attributes=$attributes iterations=$iterations errors=$errors put_item=${usec}us"
@@ -8,16 +8,30 @@
 #include <aws/core/auth/AWSCredentials.h>
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/dynamodb/DynamoDBErrors.h>
 #include <aws/dynamodb/model/PutItemRequest.h>
 #include <aws/dynamodb/model/GetItemRequest.h>
 #include <aws/dynamodb/model/DeleteItemRequest.h>
+#include <aws/dynamodb/model/UpdateItemRequest.h>
 #include <aws/dynamodb/model/QueryRequest.h>
 #include <aws/dynamodb/model/ScanRequest.h>
 #include <aws/dynamodb/model/CreateTableRequest.h>
 #include <aws/dynamodb/model/DeleteTableRequest.h>
 #include <aws/dynamodb/model/ListTablesRequest.h>
+#include <aws/dynamodb/model/BatchWriteItemRequest.h>
+#include <aws/dynamodb/model/BatchGetItemRequest.h>
+#include <aws/dynamodb/model/TransactWriteItemsRequest.h>
+#include <aws/dynamodb/model/TransactGetItemsRequest.h>
+#include <aws/dynamodb/model/TransactionCanceledException.h>
 #include <cstdio>
+#include <cctype>
 #include <fstream>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <tuple>
+#include <iterator>
 #include "library.h"
 #include "../common/common.h"
 
@@ -45,6 +59,7 @@ typedef int Tcl_Size;
                  }
 
 #define CMD_NAME(s, internal) std::sprintf((s), "_AWS_DDB_%p", (internal))
+#define SHARED_CMD_NAME(s, internal, id) std::sprintf((s), "_AWS_DDB_%p_%lu", (internal), (id))
 
 static char VAR_READ_ONLY_MSG[] = "var is read-only";
 
@@ -61,16 +76,28 @@ static int aws_sdk_tcl_dynamodb_ModuleInitialized;
 
 static char dynamodb_client_usage[] =
         "Usage dynamodbClient <method> <args>, where method can be:\n"
-        "  put_item table item_dict                                                                             \n"
+        "  put_item table item_dict ?-condition expression? ?-names dict? ?-values dict? ?-return value?        \n"
         "  get_item table key_dict                                                                              \n"
+        "  delete_item table key_dict ?-condition expression? ?-names dict? ?-values dict? ?-return value?      \n"
+        "  update_item table key_dict update_expression ?-condition expression? ?-names dict? ?-values dict?    \n"
+        "       ?-return value?                                                                                 \n"
+        "  batch_write table items_list ?-deletes keys_list? ?-concurrency n?                                   \n"
+        "  batch_get table_keys_dict ?-projection expression? ?-consistent bool? ?-concurrency n?               \n"
+        "  transact_write ops_list ?-token client_request_token?                                                \n"
+        "  transact_get gets_list                                                                               \n"
         "  query_items table query_dict ?scan_forward? ?limit? ?index_name?                                     \n"
+        "       ?-key-condition expression? ?-filter expression? ?-names dict? ?-values dict?                   \n"
+        "  query_cursor table query_dict ?scan_forward? ?limit? ?index_name?                                    \n"
+        "       ?-key-condition expression? ?-filter expression? ?-names dict? ?-values dict?                   \n"
+        "  scan table ?projection_expression? ?-segments n? ?-concurrency n? ?-command cmd? ?-limit n?          \n"
+        "       ?-filter expression? ?-expression-values dict? ?-exclusive-start-key key_dict?                  \n"
         "  create_table table key_schema_dict ?provisioned_throughput_dict? ?global_secondary_indexes_list?     \n"
         "  delete_table table                                                                                   \n"
         "  list_tables                                                                                          \n"
         "  destroy\n";
 
 
-static int
+static ClientData
 aws_sdk_tcl_dynamodb_RegisterName(const char *name, Aws::DynamoDB::DynamoDBClient *internal) {
 
     Tcl_HashEntry *entryPtr;
@@ -79,14 +106,16 @@ aws_sdk_tcl_dynamodb_RegisterName(const char *name, Aws::DynamoDB::DynamoDBClien
     Tcl_MutexLock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
     entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_dynamodb_NameToInternal_HT, (char *) name, &newEntry);
     if (newEntry) {
-        Tcl_SetHashValue(entryPtr, (ClientData) internal);
+        Tcl_SetHashValue(entryPtr, (ClientData) aws_sdk_tcl_AllocSlot(&aws_sdk_tcl_dynamodb_NameToInternal_HT, internal));
     }
+    // becomes the clientData of the handle command
+    ClientData handleRef = aws_sdk_tcl_NewHandleRef((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr), name);
     Tcl_MutexUnlock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
 
     DBG(fprintf(stderr, "--> RegisterName: name=%s internal=%p %s\n", name, internal,
                 newEntry ? "entered into" : "already in"));
 
-    return !!newEntry;
+    return handleRef;
 }
 
 static int
@@ -97,6 +126,7 @@ aws_sdk_tcl_dynamodb_UnregisterName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_dynamodb_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
+        aws_sdk_tcl_FreeSlot((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
         Tcl_DeleteHashEntry(entryPtr);
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
@@ -114,105 +144,338 @@ aws_sdk_tcl_dynamodb_GetInternalFromName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_dynamodb_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
-        internal = (Aws::DynamoDB::DynamoDBClient *) Tcl_GetHashValue(entryPtr);
+        internal = (Aws::DynamoDB::DynamoDBClient *) aws_sdk_tcl_GetSlotItem((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
 
     return internal;
 }
 
+static Aws::DynamoDB::DynamoDBClient *
+aws_sdk_tcl_dynamodb_GetInternalFromObj(Tcl_Obj *objPtr) {
+    // no locking once the object caches the slot of the handle
+    auto *internal = (Aws::DynamoDB::DynamoDBClient *) aws_sdk_tcl_GetCachedItem(objPtr, &aws_sdk_tcl_dynamodb_NameToInternal_HT);
+    if (internal == nullptr) {
+        Tcl_HashEntry *entryPtr;
+
+        Tcl_MutexLock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
+        entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_dynamodb_NameToInternal_HT, Tcl_GetString(objPtr));
+        if (entryPtr != nullptr) {
+            internal = (Aws::DynamoDB::DynamoDBClient *) aws_sdk_tcl_SetCachedItem(objPtr, (aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
+        }
+        Tcl_MutexUnlock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
+    }
+
+    return internal;
+}
+
+static void
+aws_sdk_tcl_dynamodb_DeleteClient(void *client) {
+    delete (Aws::DynamoDB::DynamoDBClient *) client;
+}
+
 int aws_sdk_tcl_dynamodb_Destroy(Tcl_Interp *interp, const char *handle) {
     Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
     if (!aws_sdk_tcl_dynamodb_UnregisterName(handle)) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
-    delete client;
+    // a shared client is only destroyed with its last handle
+    if (aws_sdk_tcl_ReleaseSharedClient(client)) {
+        aws_sdk_tcl_dynamodb_DeleteClient(client);
+    }
     Tcl_DeleteCommand(interp, handle);
     Tcl_SetObjResult(interp, Tcl_NewStringObj(handle, -1));
     return TCL_OK;
 }
 
-std::shared_ptr<Aws::DynamoDB::Model::AttributeValue> set_attribute_value(Tcl_Interp *interp, Tcl_Obj *listPtr);
-
-std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>
-set_attribute_value_to_list(Tcl_Interp *interp, Tcl_Obj *listPtr) {
-    std::vector<std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>> list_attr_value;
+// Fills "value" from a typed value: {S string}, {N number}, {BOOL bool},
+// {NULL 1}, {M {name typed_value ...}} or {L {typed_value ...}}. The
+// value is built in place, and so are the nested values of maps and lists
+// in the nodes the AttributeValue keeps them in, rather than converted to
+// temporary nodes and containers that are then copied.
+static int
+aws_sdk_tcl_dynamodb_SetAttributeValue(Tcl_Interp *interp, Tcl_Obj *specPtr, Aws::DynamoDB::Model::AttributeValue &value) {
     Tcl_Size length;
-    Tcl_ListObjLength(interp, listPtr, &length);
-    DBG(fprintf(stderr, "set_attribute_value_to_list, length: %d\n", length));
-    for (int i = 0; i < length; i++) {
-        Tcl_Obj *list_valuePtr;
-        Tcl_ListObjIndex(interp, listPtr, i, &list_valuePtr);
-        auto list_attrValue = set_attribute_value(interp, list_valuePtr);
-        list_attr_value.push_back(list_attrValue);
+    Tcl_Obj **elements;
+    if (TCL_OK != Tcl_ListObjGetElements(interp, specPtr, &length, &elements) || length != 2) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("Invalid attribute value", -1));
+        return TCL_ERROR;
+    }
+    Tcl_Size typeLength;
+    const char *type = Tcl_GetStringFromObj(elements[0], &typeLength);
+    Tcl_Obj *valuePtr = elements[1];
+
+    if (typeLength == 1 && (type[0] == 'S' || type[0] == 'N')) {
+        Tcl_Size stringLength;
+        const char *string = Tcl_GetStringFromObj(valuePtr, &stringLength);
+        if (type[0] == 'S') {
+            value.SetS(Aws::String(string, stringLength));
+        } else {
+            value.SetN(Aws::String(string, stringLength));
+        }
+    } else if (typeLength == 1 && type[0] == 'M') {
+        Tcl_Size count;
+        Tcl_Obj **objs;
+        if (TCL_OK != Tcl_ListObjGetElements(interp, valuePtr, &count, &objs)) {
+            return TCL_ERROR;
+        }
+        if (count % 2) {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("Invalid attribute value: M expects a list of names and typed values", -1));
+            return TCL_ERROR;
+        }
+        if (count == 0) {
+            value.SetM(Aws::Map<Aws::String, const std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>>());
+        }
+        for (Tcl_Size i = 0; i < count; i += 2) {
+            auto entry = std::make_shared<Aws::DynamoDB::Model::AttributeValue>();
+            if (TCL_OK != aws_sdk_tcl_dynamodb_SetAttributeValue(interp, objs[i + 1], *entry)) {
+                return TCL_ERROR;
+            }
+            Tcl_Size keyLength;
+            const char *key = Tcl_GetStringFromObj(objs[i], &keyLength);
+            value.AddMEntry(Aws::String(key, keyLength), entry);
+        }
+    } else if (typeLength == 1 && type[0] == 'L') {
+        Tcl_Size count;
+        Tcl_Obj **objs;
+        if (TCL_OK != Tcl_ListObjGetElements(interp, valuePtr, &count, &objs)) {
+            return TCL_ERROR;
+        }
+        if (count == 0) {
+            value.SetL(Aws::Vector<std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>>());
+        }
+        for (Tcl_Size i = 0; i < count; i++) {
+            auto item = std::make_shared<Aws::DynamoDB::Model::AttributeValue>();
+            if (TCL_OK != aws_sdk_tcl_dynamodb_SetAttributeValue(interp, objs[i], *item)) {
+                return TCL_ERROR;
+            }
+            value.AddLItem(item);
+        }
+    } else if (0 == strcmp("BOOL", type)) {
+        int b;
+        if (TCL_OK != Tcl_GetBooleanFromObj(interp, valuePtr, &b)) {
+            return TCL_ERROR;
+        }
+        value.SetBool(b != 0);
+    } else if (0 == strcmp("NULL", type)) {
+        value.SetNull(true);
+    } else {
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("unsupported attribute type \"%s\"", type));
+        return TCL_ERROR;
     }
-    DBG(fprintf(stderr, "set_attribute_value_to_list, size: %lu\n", list_attr_value.size()));
-    return std::make_shared<Aws::DynamoDB::Model::AttributeValue>(
-            Aws::DynamoDB::Model::AttributeValue().SetL(list_attr_value));
+    return TCL_OK;
 }
 
-std::shared_ptr<Aws::DynamoDB::Model::AttributeValue> set_attribute_value_to_map(Tcl_Interp *interp, Tcl_Obj *listPtr) {
-    std::map<std::string, const std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>> map_attr_value;
-    Tcl_Size length;
-    Tcl_ListObjLength(interp, listPtr, &length);
-    DBG(fprintf(stderr, "set_attribute_value_to_map, length: %d\n", length));
-    for (int i = 0; i < length; i += 2) {
-        Tcl_Obj *list_keyPtr, *list_valuePtr;
-        Tcl_ListObjIndex(interp, listPtr, i, &list_keyPtr);
-        Tcl_ListObjIndex(interp, listPtr, i + 1, &list_valuePtr);
-        auto map_attrValue = set_attribute_value(interp, list_valuePtr);
+// Converts a typed item or key dict, e.g. {id {S 1} n {N 2}}, to the
+// attribute map of a request.
+static int
+aws_sdk_tcl_dynamodb_GetAttributeMap(Tcl_Interp *interp, Tcl_Obj *dictPtr,
+                                     Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &attributes) {
+    Tcl_DictSearch search;
+    Tcl_Obj *key, *spec;
+    int done;
+    if (Tcl_DictObjFirst(interp, dictPtr, &search, &key, &spec, &done) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    for (; !done; Tcl_DictObjNext(&search, &key, &spec, &done)) {
+        Tcl_Size keyLength;
+        const char *keyString = Tcl_GetStringFromObj(key, &keyLength);
+        auto entry = attributes.emplace(std::piecewise_construct,
+                                        std::forward_as_tuple(keyString, keyLength),
+                                        std::forward_as_tuple());
+        if (TCL_OK != aws_sdk_tcl_dynamodb_SetAttributeValue(interp, spec, entry.first->second)) {
+            Tcl_DictObjDone(&search);
+            return TCL_ERROR;
+        }
+    }
+    Tcl_DictObjDone(&search);
+    return TCL_OK;
+}
+
+// Converts a dict of expression attribute name placeholders, e.g.
+// {#s status}, to the names of a request.
+static int
+aws_sdk_tcl_dynamodb_GetAttributeNames(Tcl_Interp *interp, Tcl_Obj *dictPtr, Aws::Map<Aws::String, Aws::String> &names) {
+    Tcl_DictSearch search;
+    Tcl_Obj *key, *value;
+    int done;
+    if (Tcl_DictObjFirst(interp, dictPtr, &search, &key, &value, &done) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    for (; !done; Tcl_DictObjNext(&search, &key, &value, &done)) {
+        names.emplace(Tcl_GetString(key), Tcl_GetString(value));
+    }
+    Tcl_DictObjDone(&search);
+    return TCL_OK;
+}
 
-        auto result = map_attr_value.insert(std::make_pair(Tcl_GetString(list_keyPtr), map_attrValue));
+// Like aws_sdk_tcl_SetErrorResult, with the failed conditions of writes
+// always reported as ConditionalCheckFailedException. A cancelled
+// transaction is reported as TransactionCanceledException, with the list
+// of the cancellation reason codes of its operations, e.g. {None
+// ConditionalCheckFailed}, appended to the error code.
+static int
+aws_sdk_tcl_dynamodb_SetErrorResult(Tcl_Interp *interp, const Aws::DynamoDB::DynamoDBError &error) {
+    if (error.GetErrorType() == Aws::DynamoDB::DynamoDBErrors::CONDITIONAL_CHECK_FAILED) {
+        return aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", error, "ConditionalCheckFailedException");
+    }
+    if (error.GetErrorType() != Aws::DynamoDB::DynamoDBErrors::TRANSACTION_CANCELED) {
+        return aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", error);
+    }
+    aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", error, "TransactionCanceledException");
 
-        // result variable holds a pair, where the first element is an iterator to the inserted element
-        // and the second element is a bool indicating whether insertion took place
-        if (!result.second) {
-            DBG(fprintf(stderr, "Duplicate key in map\n"));
-        }
+    // the modeled error is only available from a non-const error
+    Aws::DynamoDB::DynamoDBError canceled(error);
+    Tcl_Obj *reasonsPtr = Tcl_NewListObj(0, nullptr);
+    for (const auto &reason: canceled.GetModeledError<Aws::DynamoDB::Model::TransactionCanceledException>().GetCancellationReasons()) {
+        Tcl_ListObjAppendElement(interp, reasonsPtr, Tcl_NewStringObj(reason.GetCode().empty() ? "None" : reason.GetCode().c_str(), -1));
+    }
+    Tcl_Obj *returnOptionsPtr = Tcl_GetReturnOptions(interp, TCL_ERROR);
+    Tcl_IncrRefCount(returnOptionsPtr);
+    Tcl_Obj *keyPtr = Tcl_NewStringObj("-errorcode", -1);
+    Tcl_Obj *codePtr;
+    Tcl_IncrRefCount(keyPtr);
+    if (TCL_OK == Tcl_DictObjGet(interp, returnOptionsPtr, keyPtr, &codePtr) && codePtr) {
+        codePtr = Tcl_DuplicateObj(codePtr);
+        Tcl_ListObjAppendElement(interp, codePtr, reasonsPtr);
+        Tcl_SetObjErrorCode(interp, codePtr);
+    } else {
+        Tcl_DecrRefCount(reasonsPtr);
     }
-    DBG(fprintf(stderr, "set_attribute_value_to_map, map size: %lu\n", map_attr_value.size()));
-    return std::make_shared<Aws::DynamoDB::Model::AttributeValue>(
-            Aws::DynamoDB::Model::AttributeValue().SetM(map_attr_value));
+    Tcl_DecrRefCount(keyPtr);
+    Tcl_DecrRefCount(returnOptionsPtr);
+    return TCL_ERROR;
 }
 
-std::shared_ptr<Aws::DynamoDB::Model::AttributeValue> set_attribute_value(Tcl_Interp *interp, Tcl_Obj *listPtr) {
-    Tcl_Obj *typePtr, *valuePtr;
-    Tcl_ListObjIndex(interp, listPtr, 0, &typePtr);
-    Tcl_ListObjIndex(interp, listPtr, 1, &valuePtr);
-    Tcl_Size typeLength;
-    const char *type = Tcl_GetStringFromObj(typePtr, &typeLength);
-    switch (type[0]) {
-        case 'S':
-            return std::make_shared<Aws::DynamoDB::Model::AttributeValue>(
-                    Aws::DynamoDB::Model::AttributeValue().SetS(Tcl_GetString(valuePtr)));
-        case 'N':
-            if (typeLength == 1) {
-                return std::make_shared<Aws::DynamoDB::Model::AttributeValue>(
-                        Aws::DynamoDB::Model::AttributeValue().SetN(Tcl_GetString(valuePtr)));
-            } else if (0 == strcmp("NULL", type)) {
-                return std::make_shared<Aws::DynamoDB::Model::AttributeValue>(
-                        Aws::DynamoDB::Model::AttributeValue().SetNull(true));
-            }
-        case 'B':
-            if (typeLength == 1) {
-//                return Aws::DynamoDB::Model::AttributeValue().SetB(Tcl_GetString(valuePtr));
-            } else if (0 == strcmp("BOOL", type)) {
-                return std::make_shared<Aws::DynamoDB::Model::AttributeValue>(
-                        Aws::DynamoDB::Model::AttributeValue().SetBool(Tcl_GetString(valuePtr)));
+Tcl_Obj *
+get_typed_obj_from_attribute_value(Tcl_Interp *interp, const Aws::DynamoDB::Model::AttributeValue &attribute_value);
+
+// Converts the attributes returned by a write to a typed dict.
+static Tcl_Obj *
+aws_sdk_tcl_dynamodb_AttributesToDict(Tcl_Interp *interp, const Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &attributes) {
+    Tcl_Obj *dictPtr = Tcl_NewDictObj();
+    for (const auto &i: attributes) {
+        Tcl_DictObjPut(interp, dictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                       get_typed_obj_from_attribute_value(interp, i.second));
+    }
+    return dictPtr;
+}
+
+typedef struct {
+    Tcl_Obj *conditionPtr;
+    Tcl_Obj *namesPtr;
+    Tcl_Obj *valuesPtr;
+    Aws::DynamoDB::Model::ReturnValue returnValue;
+} aws_sdk_tcl_dynamodb_write_options_t;
+
+// Parses the "?-condition expression? ?-names dict? ?-values dict?
+// ?-return value?" options of the writes of single items.
+static int
+aws_sdk_tcl_dynamodb_GetWriteOptions(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], aws_sdk_tcl_dynamodb_write_options_t *options) {
+    static const char *const optionNames[] = { "-condition", "-names", "-values", "-return", NULL };
+    enum optionNames { OPT_CONDITION, OPT_NAMES, OPT_VALUES, OPT_RETURN };
+    static const char *const returnValues[] = { "NONE", "ALL_OLD", "UPDATED_OLD", "ALL_NEW", "UPDATED_NEW", NULL };
+    static const Aws::DynamoDB::Model::ReturnValue returnValueTypes[] = {
+            Aws::DynamoDB::Model::ReturnValue::NONE,
+            Aws::DynamoDB::Model::ReturnValue::ALL_OLD,
+            Aws::DynamoDB::Model::ReturnValue::UPDATED_OLD,
+            Aws::DynamoDB::Model::ReturnValue::ALL_NEW,
+            Aws::DynamoDB::Model::ReturnValue::UPDATED_NEW
+    };
+
+    options->conditionPtr = nullptr;
+    options->namesPtr = nullptr;
+    options->valuesPtr = nullptr;
+    options->returnValue = Aws::DynamoDB::Model::ReturnValue::NOT_SET;
+
+    for (int i = 0; i < objc; i++) {
+        int option;
+        if (Tcl_GetIndexFromObj(interp, objv[i], optionNames, "option", 0, &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (++i == objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("missing value for option \"%s\"", Tcl_GetString(objv[i - 1])));
+            return TCL_ERROR;
+        }
+        switch ((enum optionNames) option) {
+            case OPT_CONDITION:
+                options->conditionPtr = objv[i];
+                break;
+            case OPT_NAMES:
+                options->namesPtr = objv[i];
+                break;
+            case OPT_VALUES:
+                options->valuesPtr = objv[i];
+                break;
+            case OPT_RETURN: {
+                int returnValue;
+                if (Tcl_GetIndexFromObj(interp, objv[i], returnValues, "return value", 0, &returnValue) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                options->returnValue = returnValueTypes[returnValue];
+                break;
             }
-        case 'M':
-            return set_attribute_value_to_map(interp, valuePtr);
-        case 'L':
-            return set_attribute_value_to_list(interp, valuePtr);
+        }
+    }
+    return TCL_OK;
+}
+
+// Sets the condition and the expression attribute names and values of a
+// write request or of an operation of a transaction.
+template<typename Request>
+static int
+aws_sdk_tcl_dynamodb_SetConditionOptions(Tcl_Interp *interp, Tcl_Obj *conditionPtr, Tcl_Obj *namesPtr, Tcl_Obj *valuesPtr, Request &request) {
+    if (conditionPtr) {
+        request.SetConditionExpression(Tcl_GetString(conditionPtr));
+    }
+    if (namesPtr) {
+        Aws::Map<Aws::String, Aws::String> names;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeNames(interp, namesPtr, names)) {
+            return TCL_ERROR;
+        }
+        if (!names.empty()) {
+            request.SetExpressionAttributeNames(names);
+        }
+    }
+    if (valuesPtr) {
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> values;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, valuesPtr, values)) {
+            return TCL_ERROR;
+        }
+        if (!values.empty()) {
+            request.SetExpressionAttributeValues(std::move(values));
+        }
+    }
+    return TCL_OK;
+}
+
+// Sets the condition, the expression attribute names and values and the
+// return value of a write request.
+template<typename Request>
+static int
+aws_sdk_tcl_dynamodb_SetWriteOptions(Tcl_Interp *interp, const aws_sdk_tcl_dynamodb_write_options_t *options, Request &request) {
+    if (TCL_OK != aws_sdk_tcl_dynamodb_SetConditionOptions(interp, options->conditionPtr, options->namesPtr, options->valuesPtr, request)) {
+        return TCL_ERROR;
     }
-    return std::make_shared<Aws::DynamoDB::Model::AttributeValue>(Aws::DynamoDB::Model::AttributeValue().SetNull(true));
+    if (options->returnValue != Aws::DynamoDB::Model::ReturnValue::NOT_SET) {
+        request.SetReturnValues(options->returnValue);
+    }
+    return TCL_OK;
 }
 
-int aws_sdk_tcl_dynamodb_PutItem(Tcl_Interp *interp, const char *handle, const char *tableName, Tcl_Obj *dictPtr) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_PutItem: handle=%s tableName=%s dict=%s\n", handle, tableName,
+// Puts an item, replacing the one with the same key unless the condition
+// of -condition fails. Returns true or, with -return, the attributes it
+// asks for.
+int aws_sdk_tcl_dynamodb_PutItem(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *tableName, Tcl_Obj *dictPtr,
+                                 const aws_sdk_tcl_dynamodb_write_options_t *options) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_PutItem: handle=%s tableName=%s dict=%s\n", Tcl_GetString(handlePtr), tableName,
                 Tcl_GetString(dictPtr)));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -221,27 +484,15 @@ int aws_sdk_tcl_dynamodb_PutItem(Tcl_Interp *interp, const char *handle, const c
     Aws::DynamoDB::Model::PutItemRequest putItemRequest;
     putItemRequest.SetTableName(tableName);
 
-    Tcl_DictSearch search;
-    Tcl_Obj *key, *spec;
-    int done;
-    if (Tcl_DictObjFirst(interp, dictPtr, &search,
-                         &key, &spec, &done) != TCL_OK) {
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> item;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, dictPtr, item)) {
         return TCL_ERROR;
     }
-    for (; !done; Tcl_DictObjNext(&search, &key, &spec, &done)) {
-        Tcl_Size length;
-        Tcl_ListObjLength(interp, spec, &length);
-        if (length != 2) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("Invalid attribute value", -1));
-            return TCL_ERROR;
-        }
-        Aws::String attribute_key = Tcl_GetString(key);
-        DBG(fprintf(stderr, "key=%s spec=%s\n", attribute_key.c_str(), Tcl_GetString(spec)));
-        auto value = set_attribute_value(interp, spec);
-        DBG(fprintf(stderr, "done\n"));
-        putItemRequest.AddItem(attribute_key, *value);
+    putItemRequest.SetItem(std::move(item));
+
+    if (TCL_OK != aws_sdk_tcl_dynamodb_SetWriteOptions(interp, options, putItemRequest)) {
+        return TCL_ERROR;
     }
-    Tcl_DictObjDone(&search);
 
     DBG(fprintf(stderr, "putItemRequest ready\n"));
 
@@ -249,12 +500,15 @@ int aws_sdk_tcl_dynamodb_PutItem(Tcl_Interp *interp, const char *handle, const c
             putItemRequest);
     if (outcome.IsSuccess()) {
 //        std::cout << "Successfully added Item!" << std::endl;
-        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(true));
+        if (options->returnValue == Aws::DynamoDB::Model::ReturnValue::NOT_SET) {
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(true));
+            return TCL_OK;
+        }
+        Tcl_SetObjResult(interp, aws_sdk_tcl_dynamodb_AttributesToDict(interp, outcome.GetResult().GetAttributes()));
         return TCL_OK;
     } else {
 //        std::cerr << outcome.GetError().GetMessage() << std::endl;
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
-        return TCL_ERROR;
+        return aws_sdk_tcl_dynamodb_SetErrorResult(interp, outcome.GetError());
     }
 }
 
@@ -262,7 +516,7 @@ Tcl_Obj *
 get_typed_obj_from_attribute_value(Tcl_Interp *interp, const Aws::DynamoDB::Model::AttributeValue &attribute_value);
 
 Tcl_Obj *get_typed_obj_from_map(Tcl_Interp *interp,
-                                std::map<std::string, const std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>> map_attr_value) {
+                                const Aws::Map<Aws::String, const std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>> &map_attr_value) {
     Tcl_Obj *dictPtr = Tcl_NewDictObj();
     for (auto const &x: map_attr_value) {
         Tcl_Obj *keyPtr = Tcl_NewStringObj(x.first.c_str(), -1);
@@ -273,7 +527,7 @@ Tcl_Obj *get_typed_obj_from_map(Tcl_Interp *interp,
 }
 
 Tcl_Obj *get_typed_obj_from_list(Tcl_Interp *interp,
-                                 std::vector<std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>> list_attr_value) {
+                                 const Aws::Vector<std::shared_ptr<Aws::DynamoDB::Model::AttributeValue>> &list_attr_value) {
     Tcl_Obj *listPtr = Tcl_NewListObj(0, NULL);
     for (auto const &x: list_attr_value) {
         Tcl_Obj *valuePtr = get_typed_obj_from_attribute_value(interp, *x);
@@ -314,10 +568,10 @@ get_typed_obj_from_attribute_value(Tcl_Interp *interp, const Aws::DynamoDB::Mode
     return listPtr;
 }
 
-int aws_sdk_tcl_dynamodb_GetItem(Tcl_Interp *interp, const char *handle, const char *tableName, Tcl_Obj *dictPtr) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_GetItem: handle=%s tableName=%s dict=%s\n", handle, tableName,
+int aws_sdk_tcl_dynamodb_GetItem(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *tableName, Tcl_Obj *dictPtr) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_GetItem: handle=%s tableName=%s dict=%s\n", Tcl_GetString(handlePtr), tableName,
                 Tcl_GetString(dictPtr)));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -326,27 +580,11 @@ int aws_sdk_tcl_dynamodb_GetItem(Tcl_Interp *interp, const char *handle, const c
     Aws::DynamoDB::Model::GetItemRequest getItemRequest;
     getItemRequest.SetTableName(tableName);
 
-    Tcl_DictSearch search;
-    Tcl_Obj *key, *spec;
-    int done;
-    if (Tcl_DictObjFirst(interp, dictPtr, &search,
-                         &key, &spec, &done) != TCL_OK) {
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> key;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, dictPtr, key)) {
         return TCL_ERROR;
     }
-    for (; !done; Tcl_DictObjNext(&search, &key, &spec, &done)) {
-        Tcl_Size length;
-        Tcl_ListObjLength(interp, spec, &length);
-        if (length != 2) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("Invalid attribute value", -1));
-            return TCL_ERROR;
-        }
-        Aws::String attribute_key = Tcl_GetString(key);
-        DBG(fprintf(stderr, "key=%s spec=%s\n", attribute_key.c_str(), Tcl_GetString(spec)));
-        auto value = set_attribute_value(interp, spec);
-        DBG(fprintf(stderr, "done\n"));
-        getItemRequest.AddKey(attribute_key, *value);
-    }
-    Tcl_DictObjDone(&search);
+    getItemRequest.SetKey(std::move(key));
 
     DBG(fprintf(stderr, "getItemRequest ready\n"));
 
@@ -367,15 +605,18 @@ int aws_sdk_tcl_dynamodb_GetItem(Tcl_Interp *interp, const char *handle, const c
         Tcl_SetObjResult(interp, result);
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
-int aws_sdk_tcl_dynamodb_DeleteItem(Tcl_Interp *interp, const char *handle, const char *tableName, Tcl_Obj *dictPtr) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_DeleteItem: handle=%s tableName=%s dict=%s\n", handle, tableName,
+// Deletes an item unless the condition of -condition fails. Returns true
+// or, with -return, the attributes it asks for.
+int aws_sdk_tcl_dynamodb_DeleteItem(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *tableName, Tcl_Obj *dictPtr,
+                                    const aws_sdk_tcl_dynamodb_write_options_t *options) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_DeleteItem: handle=%s tableName=%s dict=%s\n", Tcl_GetString(handlePtr), tableName,
                 Tcl_GetString(dictPtr)));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -384,154 +625,1108 @@ int aws_sdk_tcl_dynamodb_DeleteItem(Tcl_Interp *interp, const char *handle, cons
     Aws::DynamoDB::Model::DeleteItemRequest deleteItemRequest;
     deleteItemRequest.SetTableName(tableName);
 
-    Tcl_DictSearch search;
-    Tcl_Obj *key, *spec;
-    int done;
-    if (Tcl_DictObjFirst(interp, dictPtr, &search,
-                         &key, &spec, &done) != TCL_OK) {
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> key;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, dictPtr, key)) {
         return TCL_ERROR;
     }
-    for (; !done; Tcl_DictObjNext(&search, &key, &spec, &done)) {
-        Tcl_Size length;
-        Tcl_ListObjLength(interp, spec, &length);
-        if (length != 2) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("Invalid attribute value", -1));
-            return TCL_ERROR;
-        }
-        Aws::String attribute_key = Tcl_GetString(key);
-        DBG(fprintf(stderr, "key=%s spec=%s\n", attribute_key.c_str(), Tcl_GetString(spec)));
-        auto value = set_attribute_value(interp, spec);
-        DBG(fprintf(stderr, "done\n"));
-        deleteItemRequest.AddKey(attribute_key, *value);
+    deleteItemRequest.SetKey(std::move(key));
+
+    if (TCL_OK != aws_sdk_tcl_dynamodb_SetWriteOptions(interp, options, deleteItemRequest)) {
+        return TCL_ERROR;
     }
-    Tcl_DictObjDone(&search);
 
     DBG(fprintf(stderr, "deleteItemRequest ready\n"));
 
     const Aws::DynamoDB::Model::DeleteItemOutcome outcome = client->DeleteItem(
             deleteItemRequest);
     if (outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+        if (options->returnValue == Aws::DynamoDB::Model::ReturnValue::NOT_SET) {
+            Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+            return TCL_OK;
+        }
+        Tcl_SetObjResult(interp, aws_sdk_tcl_dynamodb_AttributesToDict(interp, outcome.GetResult().GetAttributes()));
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
-        return TCL_ERROR;
+        return aws_sdk_tcl_dynamodb_SetErrorResult(interp, outcome.GetError());
     }
 }
 
-int aws_sdk_tcl_dynamodb_QueryItems(
+// Applies an update expression, e.g. "SET n = n + :one", to the item with
+// the given key, creating it if needed. Returns true or, with -return, the
+// attributes it asks for.
+int aws_sdk_tcl_dynamodb_UpdateItem(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *tableName,
-        Tcl_Obj *dictPtr,
-        Tcl_Obj *projectionExpressionPtr,
-        Tcl_Obj *scanForwardPtr,
-        Tcl_Obj *limitPtr,
-        Tcl_Obj *indexNamePtr
+        Tcl_Obj *keyDictPtr,
+        Tcl_Obj *updateExpressionPtr,
+        const aws_sdk_tcl_dynamodb_write_options_t *options
 ) {
-
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_QueryItems: handle=%s tableName=%s dict=%s\n", handle, tableName,
-                Tcl_GetString(dictPtr)));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_UpdateItem: handle=%s tableName=%s key=%s expression=%s\n", Tcl_GetString(handlePtr),
+                tableName, Tcl_GetString(keyDictPtr), Tcl_GetString(updateExpressionPtr)));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
 
-    Aws::DynamoDB::Model::QueryRequest request;
-    request.SetTableName(tableName);
-    if (projectionExpressionPtr) {
-        Tcl_Size projectionExpressionLength;
-        const char *projectionExpression = Tcl_GetStringFromObj(projectionExpressionPtr, &projectionExpressionLength);
-        if (projectionExpressionLength > 0) {
-            request.SetProjectionExpression(projectionExpression);
-        }
+    Aws::DynamoDB::Model::UpdateItemRequest updateItemRequest;
+    updateItemRequest.SetTableName(tableName);
+
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> key;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, keyDictPtr, key)) {
+        return TCL_ERROR;
     }
-    if (scanForwardPtr) {
-        int scanForward;
-        Tcl_GetBooleanFromObj(interp, scanForwardPtr, &scanForward);
-        request.SetScanIndexForward(scanForward);
+    updateItemRequest.SetKey(std::move(key));
+    updateItemRequest.SetUpdateExpression(Tcl_GetString(updateExpressionPtr));
+    if (TCL_OK != aws_sdk_tcl_dynamodb_SetWriteOptions(interp, options, updateItemRequest)) {
+        return TCL_ERROR;
     }
-    int limit = 0;
-    if (limitPtr) {
-        Tcl_GetIntFromObj(interp, limitPtr, &limit);
-        request.SetLimit(limit);
+
+    const Aws::DynamoDB::Model::UpdateItemOutcome outcome = client->UpdateItem(updateItemRequest);
+    if (!outcome.IsSuccess()) {
+        return aws_sdk_tcl_dynamodb_SetErrorResult(interp, outcome.GetError());
     }
-    if (indexNamePtr) {
-        request.SetIndexName(Tcl_GetString(indexNamePtr));
+    if (options->returnValue == Aws::DynamoDB::Model::ReturnValue::NOT_SET) {
+        Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+        return TCL_OK;
     }
+    Tcl_SetObjResult(interp, aws_sdk_tcl_dynamodb_AttributesToDict(interp, outcome.GetResult().GetAttributes()));
+    return TCL_OK;
+}
 
-    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> attributeValues;
-    Aws::String keyConditionExpression;
+// Waits before sending unprocessed items or keys again: 50ms, 100ms, ...
+// up to 5s after the given number of attempts, with full jitter.
+static void
+aws_sdk_tcl_dynamodb_Backoff(std::minstd_rand &generator, int attempts) {
+    long ceiling = std::min(5000L, 50L << std::min(attempts - 1, 10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+            std::uniform_int_distribution<long>(0, ceiling)(generator)));
+}
 
-    Tcl_DictSearch search;
-    Tcl_Obj *key, *spec;
-    int done;
-    if (Tcl_DictObjFirst(interp, dictPtr, &search,
-                         &key, &spec, &done) != TCL_OK) {
-        return TCL_ERROR;
-    }
-    for (; !done; Tcl_DictObjNext(&search, &key, &spec, &done)) {
-        Tcl_Size length;
-        Tcl_ListObjLength(interp, spec, &length);
-        if (length != 2) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj("Invalid attribute value", -1));
+static int
+aws_sdk_tcl_dynamodb_GetBatchWriteOptions(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], Tcl_Obj **deletesPtr, int *concurrency) {
+    static const char *const options[] = { "-deletes", "-concurrency", NULL };
+    enum options { OPT_DELETES, OPT_CONCURRENCY };
+
+    *deletesPtr = nullptr;
+    *concurrency = 4;
+
+    for (int i = 0; i < objc; i++) {
+        int option;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &option) != TCL_OK) {
             return TCL_ERROR;
         }
-        Aws::String attribute_key = Tcl_GetString(key);
-        DBG(fprintf(stderr, "key=%s spec=%s\n", attribute_key.c_str(), Tcl_GetString(spec)));
-        auto value = set_attribute_value(interp, spec);
-        attributeValues.emplace(":" + attribute_key, *value);
-
-        if (keyConditionExpression.length() > 0) {
-            keyConditionExpression.append(" AND ");
+        if (++i == objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("missing value for option \"%s\"", Tcl_GetString(objv[i - 1])));
+            return TCL_ERROR;
+        }
+        switch ((enum options) option) {
+            case OPT_DELETES:
+                *deletesPtr = objv[i];
+                break;
+            case OPT_CONCURRENCY:
+                if (Tcl_GetIntFromObj(interp, objv[i], concurrency) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                if (*concurrency <= 0) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("-concurrency: positive integer expected", -1));
+                    return TCL_ERROR;
+                }
+                break;
         }
-        keyConditionExpression.append(attribute_key);
-        keyConditionExpression.append(" = :");
-        keyConditionExpression.append(attribute_key);
     }
-    Tcl_DictObjDone(&search);
+    return TCL_OK;
+}
+
+// Writes the items and deletes the keys in batches of 25, the most that
+// BatchWriteItem accepts, with up to "concurrency" batches in flight.
+// Items the service leaves unprocessed, e.g. when the table is
+// throttled, are sent again after an exponential backoff with jitter.
+// Returns the number of writes.
+int aws_sdk_tcl_dynamodb_BatchWrite(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *tableName, Tcl_Obj *itemsPtr, Tcl_Obj *deletesPtr, int concurrency) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_BatchWrite: handle=%s tableName=%s\n", Tcl_GetString(handlePtr), tableName));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+
+    const size_t max_batch_size = 25;
+    const int max_attempts = 10;
+    const Aws::String table = tableName;
+
+    Aws::Vector<Aws::DynamoDB::Model::WriteRequest> writes;
+    Tcl_Size itemCount, deleteCount = 0;
+    Tcl_Obj **itemObjs, **deleteObjs = nullptr;
+    if (TCL_OK != Tcl_ListObjGetElements(interp, itemsPtr, &itemCount, &itemObjs)
+        || (deletesPtr && TCL_OK != Tcl_ListObjGetElements(interp, deletesPtr, &deleteCount, &deleteObjs))) {
+        return TCL_ERROR;
+    }
+    writes.reserve(itemCount + deleteCount);
+    for (Tcl_Size i = 0; i < itemCount; i++) {
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> item;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, itemObjs[i], item)) {
+            return TCL_ERROR;
+        }
+        writes.push_back(Aws::DynamoDB::Model::WriteRequest().WithPutRequest(
+                Aws::DynamoDB::Model::PutRequest().WithItem(std::move(item))));
+    }
+    for (Tcl_Size i = 0; i < deleteCount; i++) {
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> key;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, deleteObjs[i], key)) {
+            return TCL_ERROR;
+        }
+        writes.push_back(Aws::DynamoDB::Model::WriteRequest().WithDeleteRequest(
+                Aws::DynamoDB::Model::DeleteRequest().WithKey(std::move(key))));
+    }
+
+    // a batch and the number of times it has been sent
+    std::deque<std::pair<Aws::Vector<Aws::DynamoDB::Model::WriteRequest>, int>> pending;
+    for (size_t i = 0; i < writes.size(); i += max_batch_size) {
+        auto last = writes.begin() + (long) std::min(i + max_batch_size, writes.size());
+        pending.emplace_back(Aws::Vector<Aws::DynamoDB::Model::WriteRequest>(std::make_move_iterator(writes.begin() + (long) i), std::make_move_iterator(last)), 0);
+    }
+
+    std::minstd_rand generator(std::random_device{}());
+    std::deque<std::pair<int, Aws::DynamoDB::Model::BatchWriteItemOutcomeCallable>> inflight;
+    int failed = 0;
+    while (!pending.empty() || !inflight.empty()) {
+        while (!failed && !pending.empty() && inflight.size() < (size_t) concurrency) {
+            Aws::DynamoDB::Model::BatchWriteItemRequest request;
+            request.AddRequestItems(table, pending.front().first);
+            inflight.emplace_back(pending.front().second + 1, client->BatchWriteItemCallable(request));
+            pending.pop_front();
+        }
+        if (inflight.empty()) {
+            break;
+        }
+        int attempts = inflight.front().first;
+        Aws::DynamoDB::Model::BatchWriteItemOutcome outcome = inflight.front().second.get();
+        inflight.pop_front();
+        if (failed) {
+            // the batches in flight are awaited before returning the error
+            continue;
+        }
+        if (!outcome.IsSuccess()) {
+            aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
+            failed = 1;
+            continue;
+        }
+        const auto &unprocessed = outcome.GetResult().GetUnprocessedItems();
+        auto it = unprocessed.find(table);
+        if (it == unprocessed.end() || it->second.empty()) {
+            continue;
+        }
+        if (attempts >= max_attempts) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("%d items still unprocessed after %d attempts",
+                                                   (int) it->second.size(), attempts));
+            Tcl_SetErrorCode(interp, "AWS", "DynamoDB", "UnprocessedItems", "-1", "1", "", NULL);
+            failed = 1;
+            continue;
+        }
+        aws_sdk_tcl_dynamodb_Backoff(generator, attempts);
+        pending.emplace_back(it->second, attempts);
+    }
+    if (failed) {
+        return TCL_ERROR;
+    }
+
+    Tcl_SetObjResult(interp, Tcl_NewWideIntObj((Tcl_WideInt) writes.size()));
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_dynamodb_GetBatchGetOptions(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], Tcl_Obj **projectionPtr, int *consistent, int *concurrency) {
+    static const char *const options[] = { "-projection", "-consistent", "-concurrency", NULL };
+    enum options { OPT_PROJECTION, OPT_CONSISTENT, OPT_CONCURRENCY };
+
+    *projectionPtr = nullptr;
+    *consistent = 0;
+    *concurrency = 4;
+
+    for (int i = 0; i < objc; i++) {
+        int option;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (++i == objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("missing value for option \"%s\"", Tcl_GetString(objv[i - 1])));
+            return TCL_ERROR;
+        }
+        switch ((enum options) option) {
+            case OPT_PROJECTION:
+                *projectionPtr = objv[i];
+                break;
+            case OPT_CONSISTENT:
+                if (Tcl_GetBooleanFromObj(interp, objv[i], consistent) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                break;
+            case OPT_CONCURRENCY:
+                if (Tcl_GetIntFromObj(interp, objv[i], concurrency) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                if (*concurrency <= 0) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("-concurrency: positive integer expected", -1));
+                    return TCL_ERROR;
+                }
+                break;
+        }
+    }
+    return TCL_OK;
+}
+
+// Gets the items with the keys of table_keys_dict, {table keys_list ...},
+// with BatchGetItem calls of at most 100 keys, the most it accepts, with
+// up to "concurrency" calls in flight. Unprocessed keys are asked for
+// again after a backoff. Returns a dict of the found items by table, in
+// no particular order.
+int aws_sdk_tcl_dynamodb_BatchGet(Tcl_Interp *interp, Tcl_Obj *handlePtr, Tcl_Obj *tableKeysDictPtr, Tcl_Obj *projectionPtr, int consistent, int concurrency) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_BatchGet: handle=%s dict=%s\n", Tcl_GetString(handlePtr), Tcl_GetString(tableKeysDictPtr)));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+
+    const size_t max_batch_size = 100;
+    const int max_attempts = 10;
+
+    // a batch of keys of a table and the number of times it has been sent
+    std::deque<std::pair<Aws::Map<Aws::String, Aws::DynamoDB::Model::KeysAndAttributes>, int>> pending;
+    Tcl_Obj *resultDictPtr = Tcl_NewDictObj();
+    Tcl_DictSearch search;
+    Tcl_Obj *table, *keysPtr;
+    int done;
+    if (Tcl_DictObjFirst(interp, tableKeysDictPtr, &search, &table, &keysPtr, &done) != TCL_OK) {
+        Tcl_DecrRefCount(resultDictPtr);
+        return TCL_ERROR;
+    }
+    for (; !done; Tcl_DictObjNext(&search, &table, &keysPtr, &done)) {
+        Tcl_Size keyCount;
+        Tcl_Obj **keyObjs;
+        if (TCL_OK != Tcl_ListObjGetElements(interp, keysPtr, &keyCount, &keyObjs)) {
+            Tcl_DictObjDone(&search);
+            Tcl_DecrRefCount(resultDictPtr);
+            return TCL_ERROR;
+        }
+        // every table is in the result, even when none of its items is found
+        Tcl_DictObjPut(interp, resultDictPtr, table, Tcl_NewListObj(0, nullptr));
+        for (Tcl_Size i = 0; i < keyCount; i += (Tcl_Size) max_batch_size) {
+            Aws::DynamoDB::Model::KeysAndAttributes keysAndAttributes;
+            if (projectionPtr) {
+                keysAndAttributes.SetProjectionExpression(Tcl_GetString(projectionPtr));
+            }
+            if (consistent) {
+                keysAndAttributes.SetConsistentRead(true);
+            }
+            for (Tcl_Size j = i; j < keyCount && j < i + (Tcl_Size) max_batch_size; j++) {
+                Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> key;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, keyObjs[j], key)) {
+                    Tcl_DictObjDone(&search);
+                    Tcl_DecrRefCount(resultDictPtr);
+                    return TCL_ERROR;
+                }
+                keysAndAttributes.AddKeys(std::move(key));
+            }
+            Aws::Map<Aws::String, Aws::DynamoDB::Model::KeysAndAttributes> requestItems;
+            requestItems.emplace(Tcl_GetString(table), keysAndAttributes);
+            pending.emplace_back(requestItems, 0);
+        }
+    }
+    Tcl_DictObjDone(&search);
+
+    std::minstd_rand generator(std::random_device{}());
+    std::deque<std::pair<int, Aws::DynamoDB::Model::BatchGetItemOutcomeCallable>> inflight;
+    int failed = 0;
+    while (!pending.empty() || !inflight.empty()) {
+        while (!failed && !pending.empty() && inflight.size() < (size_t) concurrency) {
+            Aws::DynamoDB::Model::BatchGetItemRequest request;
+            request.SetRequestItems(pending.front().first);
+            inflight.emplace_back(pending.front().second + 1, client->BatchGetItemCallable(request));
+            pending.pop_front();
+        }
+        if (inflight.empty()) {
+            break;
+        }
+        int attempts = inflight.front().first;
+        Aws::DynamoDB::Model::BatchGetItemOutcome outcome = inflight.front().second.get();
+        inflight.pop_front();
+        if (failed) {
+            // the batches in flight are awaited before returning the error
+            continue;
+        }
+        if (!outcome.IsSuccess()) {
+            aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
+            failed = 1;
+            continue;
+        }
+        for (const auto &tableItems: outcome.GetResult().GetResponses()) {
+            Tcl_Obj *tablePtr = Tcl_NewStringObj(tableItems.first.c_str(), -1);
+            Tcl_Obj *itemsPtr;
+            Tcl_IncrRefCount(tablePtr);
+            Tcl_DictObjGet(interp, resultDictPtr, tablePtr, &itemsPtr);
+            if (Tcl_IsShared(itemsPtr)) {
+                itemsPtr = Tcl_DuplicateObj(itemsPtr);
+                Tcl_DictObjPut(interp, resultDictPtr, tablePtr, itemsPtr);
+            }
+            for (const auto &item: tableItems.second) {
+                Tcl_Obj *itemDictPtr = Tcl_NewDictObj();
+                for (const auto &i: item) {
+                    Tcl_DictObjPut(interp, itemDictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                                   get_typed_obj_from_attribute_value(interp, i.second));
+                }
+                Tcl_ListObjAppendElement(interp, itemsPtr, itemDictPtr);
+            }
+            Tcl_DecrRefCount(tablePtr);
+        }
+        const auto &unprocessed = outcome.GetResult().GetUnprocessedKeys();
+        if (unprocessed.empty()) {
+            continue;
+        }
+        if (attempts >= max_attempts) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("keys still unprocessed after %d attempts", attempts));
+            Tcl_SetErrorCode(interp, "AWS", "DynamoDB", "UnprocessedKeys", "-1", "1", "", NULL);
+            failed = 1;
+            continue;
+        }
+        aws_sdk_tcl_dynamodb_Backoff(generator, attempts);
+        pending.emplace_back(unprocessed, attempts);
+    }
+    if (failed) {
+        Tcl_DecrRefCount(resultDictPtr);
+        return TCL_ERROR;
+    }
+
+    Tcl_SetObjResult(interp, resultDictPtr);
+    return TCL_OK;
+}
+
+// The fields of the dict of an operation of a transaction.
+typedef struct {
+    Tcl_Obj *tablePtr;
+    Tcl_Obj *itemPtr;
+    Tcl_Obj *keyPtr;
+    Tcl_Obj *updatePtr;
+    Tcl_Obj *conditionPtr;
+    Tcl_Obj *namesPtr;
+    Tcl_Obj *valuesPtr;
+    Tcl_Obj *projectionPtr;
+} aws_sdk_tcl_dynamodb_transact_op_t;
+
+static int
+aws_sdk_tcl_dynamodb_GetTransactOp(Tcl_Interp *interp, Tcl_Obj *opDictPtr, aws_sdk_tcl_dynamodb_transact_op_t *op) {
+    static const char *const fieldNames[] = {
+            "table", "item", "key", "update", "condition", "names", "values", "projection", NULL
+    };
+    Tcl_Obj **fields[] = {
+            &op->tablePtr, &op->itemPtr, &op->keyPtr, &op->updatePtr,
+            &op->conditionPtr, &op->namesPtr, &op->valuesPtr, &op->projectionPtr
+    };
+    for (int i = 0; fieldNames[i]; i++) {
+        Tcl_Obj *fieldPtr = Tcl_NewStringObj(fieldNames[i], -1);
+        Tcl_IncrRefCount(fieldPtr);
+        int rc = Tcl_DictObjGet(interp, opDictPtr, fieldPtr, fields[i]);
+        Tcl_DecrRefCount(fieldPtr);
+        if (rc != TCL_OK) {
+            return TCL_ERROR;
+        }
+    }
+    if (!op->tablePtr) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("operation without a table", -1));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_dynamodb_RequireField(Tcl_Interp *interp, Tcl_Obj *fieldPtr, const char *operation, const char *field) {
+    if (!fieldPtr) {
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("%s operation without %s", operation, field));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+// Converts an operation of transact_write, a list of its type, put,
+// update, delete or condition_check, and of a dict of its fields.
+static int
+aws_sdk_tcl_dynamodb_GetTransactWriteItem(Tcl_Interp *interp, Tcl_Obj *opPtr, Aws::DynamoDB::Model::TransactWriteItem &writeItem) {
+    static const char *const opTypes[] = { "put", "update", "delete", "condition_check", NULL };
+    enum opTypes { OP_PUT, OP_UPDATE, OP_DELETE, OP_CONDITION_CHECK };
+
+    Tcl_Size length;
+    Tcl_Obj **elements;
+    if (TCL_OK != Tcl_ListObjGetElements(interp, opPtr, &length, &elements)) {
+        return TCL_ERROR;
+    }
+    if (length != 2) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("operation: list of type and field dict expected", -1));
+        return TCL_ERROR;
+    }
+    int opType;
+    if (TCL_OK != Tcl_GetIndexFromObj(interp, elements[0], opTypes, "operation", 0, &opType)) {
+        return TCL_ERROR;
+    }
+    aws_sdk_tcl_dynamodb_transact_op_t op;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetTransactOp(interp, elements[1], &op)) {
+        return TCL_ERROR;
+    }
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> attributes;
+    switch ((enum opTypes) opType) {
+        case OP_PUT: {
+            Aws::DynamoDB::Model::Put put;
+            put.SetTableName(Tcl_GetString(op.tablePtr));
+            if (TCL_OK != aws_sdk_tcl_dynamodb_RequireField(interp, op.itemPtr, "put", "item")
+                || TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, op.itemPtr, attributes)
+                || TCL_OK != aws_sdk_tcl_dynamodb_SetConditionOptions(interp, op.conditionPtr, op.namesPtr, op.valuesPtr, put)) {
+                return TCL_ERROR;
+            }
+            put.SetItem(std::move(attributes));
+            writeItem.SetPut(put);
+            break;
+        }
+        case OP_UPDATE: {
+            Aws::DynamoDB::Model::Update update;
+            update.SetTableName(Tcl_GetString(op.tablePtr));
+            if (TCL_OK != aws_sdk_tcl_dynamodb_RequireField(interp, op.keyPtr, "update", "key")
+                || TCL_OK != aws_sdk_tcl_dynamodb_RequireField(interp, op.updatePtr, "update", "update")
+                || TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, op.keyPtr, attributes)
+                || TCL_OK != aws_sdk_tcl_dynamodb_SetConditionOptions(interp, op.conditionPtr, op.namesPtr, op.valuesPtr, update)) {
+                return TCL_ERROR;
+            }
+            update.SetKey(std::move(attributes));
+            update.SetUpdateExpression(Tcl_GetString(op.updatePtr));
+            writeItem.SetUpdate(update);
+            break;
+        }
+        case OP_DELETE: {
+            Aws::DynamoDB::Model::Delete del;
+            del.SetTableName(Tcl_GetString(op.tablePtr));
+            if (TCL_OK != aws_sdk_tcl_dynamodb_RequireField(interp, op.keyPtr, "delete", "key")
+                || TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, op.keyPtr, attributes)
+                || TCL_OK != aws_sdk_tcl_dynamodb_SetConditionOptions(interp, op.conditionPtr, op.namesPtr, op.valuesPtr, del)) {
+                return TCL_ERROR;
+            }
+            del.SetKey(std::move(attributes));
+            writeItem.SetDelete(del);
+            break;
+        }
+        case OP_CONDITION_CHECK: {
+            Aws::DynamoDB::Model::ConditionCheck check;
+            check.SetTableName(Tcl_GetString(op.tablePtr));
+            if (TCL_OK != aws_sdk_tcl_dynamodb_RequireField(interp, op.keyPtr, "condition_check", "key")
+                || TCL_OK != aws_sdk_tcl_dynamodb_RequireField(interp, op.conditionPtr, "condition_check", "condition")
+                || TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, op.keyPtr, attributes)
+                || TCL_OK != aws_sdk_tcl_dynamodb_SetConditionOptions(interp, op.conditionPtr, op.namesPtr, op.valuesPtr, check)) {
+                return TCL_ERROR;
+            }
+            check.SetKey(std::move(attributes));
+            writeItem.SetConditionCheck(check);
+            break;
+        }
+    }
+    return TCL_OK;
+}
+
+// The most operations a transaction accepts.
+#define AWS_SDK_TCL_DYNAMODB_MAX_TRANSACT_ITEMS 100
+
+// Applies the operations of ops_list all together or not at all, in a
+// single TransactWriteItems request. The token makes retries of the same
+// transaction idempotent.
+int aws_sdk_tcl_dynamodb_TransactWrite(Tcl_Interp *interp, Tcl_Obj *handlePtr, Tcl_Obj *opsListPtr, Tcl_Obj *tokenPtr) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_TransactWrite: handle=%s ops=%s\n", Tcl_GetString(handlePtr), Tcl_GetString(opsListPtr)));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+
+    Tcl_Size opCount;
+    Tcl_Obj **opObjs;
+    if (TCL_OK != Tcl_ListObjGetElements(interp, opsListPtr, &opCount, &opObjs)) {
+        return TCL_ERROR;
+    }
+    if (opCount == 0 || opCount > AWS_SDK_TCL_DYNAMODB_MAX_TRANSACT_ITEMS) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("ops_list: 1 to " XSTR(AWS_SDK_TCL_DYNAMODB_MAX_TRANSACT_ITEMS) " operations expected", -1));
+        return TCL_ERROR;
+    }
+
+    Aws::DynamoDB::Model::TransactWriteItemsRequest request;
+    for (Tcl_Size i = 0; i < opCount; i++) {
+        Aws::DynamoDB::Model::TransactWriteItem writeItem;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetTransactWriteItem(interp, opObjs[i], writeItem)) {
+            return TCL_ERROR;
+        }
+        request.AddTransactItems(writeItem);
+    }
+    if (tokenPtr) {
+        request.SetClientRequestToken(Tcl_GetString(tokenPtr));
+    }
+
+    const Aws::DynamoDB::Model::TransactWriteItemsOutcome outcome = client->TransactWriteItems(request);
+    if (!outcome.IsSuccess()) {
+        return aws_sdk_tcl_dynamodb_SetErrorResult(interp, outcome.GetError());
+    }
+    Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
+    return TCL_OK;
+}
+
+// Gets the items of gets_list, dicts of a table, a key and optionally a
+// projection expression and its names, as of a single point in time.
+// Returns the list of the items, in order, with an empty dict for the ones
+// that do not exist.
+int aws_sdk_tcl_dynamodb_TransactGet(Tcl_Interp *interp, Tcl_Obj *handlePtr, Tcl_Obj *getsListPtr) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_TransactGet: handle=%s gets=%s\n", Tcl_GetString(handlePtr), Tcl_GetString(getsListPtr)));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+
+    Tcl_Size getCount;
+    Tcl_Obj **getObjs;
+    if (TCL_OK != Tcl_ListObjGetElements(interp, getsListPtr, &getCount, &getObjs)) {
+        return TCL_ERROR;
+    }
+    if (getCount == 0 || getCount > AWS_SDK_TCL_DYNAMODB_MAX_TRANSACT_ITEMS) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("gets_list: 1 to " XSTR(AWS_SDK_TCL_DYNAMODB_MAX_TRANSACT_ITEMS) " gets expected", -1));
+        return TCL_ERROR;
+    }
+
+    Aws::DynamoDB::Model::TransactGetItemsRequest request;
+    for (Tcl_Size i = 0; i < getCount; i++) {
+        aws_sdk_tcl_dynamodb_transact_op_t op;
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> key;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetTransactOp(interp, getObjs[i], &op)
+            || TCL_OK != aws_sdk_tcl_dynamodb_RequireField(interp, op.keyPtr, "get", "key")
+            || TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, op.keyPtr, key)) {
+            return TCL_ERROR;
+        }
+        Aws::DynamoDB::Model::Get get;
+        get.SetTableName(Tcl_GetString(op.tablePtr));
+        get.SetKey(std::move(key));
+        if (op.projectionPtr) {
+            get.SetProjectionExpression(Tcl_GetString(op.projectionPtr));
+        }
+        if (op.namesPtr) {
+            Aws::Map<Aws::String, Aws::String> names;
+            if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeNames(interp, op.namesPtr, names)) {
+                return TCL_ERROR;
+            }
+            if (!names.empty()) {
+                get.SetExpressionAttributeNames(names);
+            }
+        }
+        Aws::DynamoDB::Model::TransactGetItem getItem;
+        getItem.SetGet(get);
+        request.AddTransactItems(getItem);
+    }
+
+    const Aws::DynamoDB::Model::TransactGetItemsOutcome outcome = client->TransactGetItems(request);
+    if (!outcome.IsSuccess()) {
+        return aws_sdk_tcl_dynamodb_SetErrorResult(interp, outcome.GetError());
+    }
+    Tcl_Obj *resultListPtr = Tcl_NewListObj(0, nullptr);
+    for (const auto &response: outcome.GetResult().GetResponses()) {
+        Tcl_Obj *itemDictPtr = Tcl_NewDictObj();
+        for (const auto &i: response.GetItem()) {
+            Tcl_DictObjPut(interp, itemDictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                           get_typed_obj_from_attribute_value(interp, i.second));
+        }
+        Tcl_ListObjAppendElement(interp, resultListPtr, itemDictPtr);
+    }
+    Tcl_SetObjResult(interp, resultListPtr);
+    return TCL_OK;
+}
+
+typedef struct {
+    Tcl_Obj *keyConditionPtr;
+    Tcl_Obj *filterPtr;
+    Tcl_Obj *namesPtr;
+    Tcl_Obj *valuesPtr;
+} aws_sdk_tcl_dynamodb_query_options_t;
+
+// Parses the arguments of query_items and query_cursor after query_dict:
+// up to four positional arguments, up to the first option name, followed
+// by the options. "positional" is set to the number of the former.
+static int
+aws_sdk_tcl_dynamodb_GetQueryOptions(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], int *positional, aws_sdk_tcl_dynamodb_query_options_t *options) {
+    static const char *const optionNames[] = { "-key-condition", "-filter", "-names", "-values", NULL };
+    enum optionNames { OPT_KEY_CONDITION, OPT_FILTER, OPT_NAMES, OPT_VALUES };
+
+    options->keyConditionPtr = nullptr;
+    options->filterPtr = nullptr;
+    options->namesPtr = nullptr;
+    options->valuesPtr = nullptr;
+
+    int i = 0;
+    int option;
+    while (i < objc && i < 4 && Tcl_GetIndexFromObj(nullptr, objv[i], optionNames, "option", TCL_EXACT, &option) != TCL_OK) {
+        i++;
+    }
+    *positional = i;
+    for (; i < objc; i++) {
+        if (Tcl_GetIndexFromObj(interp, objv[i], optionNames, "option", 0, &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (++i == objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("missing value for option \"%s\"", Tcl_GetString(objv[i - 1])));
+            return TCL_ERROR;
+        }
+        switch ((enum optionNames) option) {
+            case OPT_KEY_CONDITION:
+                options->keyConditionPtr = objv[i];
+                break;
+            case OPT_FILTER:
+                options->filterPtr = objv[i];
+                break;
+            case OPT_NAMES:
+                options->namesPtr = objv[i];
+                break;
+            case OPT_VALUES:
+                options->valuesPtr = objv[i];
+                break;
+        }
+    }
+    return TCL_OK;
+}
+
+// Builds the request of query_items and query_cursor. Unless a key
+// condition expression is given, the key condition is the equality of
+// every attribute of query_dict; either way, the attributes of query_dict
+// are available to the expressions as ":attribute". "limit" is set to the
+// most items to return, 0 when there is no limit.
+// Whether an expression refers to a value placeholder, e.g. ":pk", as a
+// whole token and not as the prefix of a longer one such as ":pk2".
+static bool
+aws_sdk_tcl_dynamodb_ExpressionUses(const Aws::String &expression, const Aws::String &placeholder) {
+    for (size_t pos = expression.find(placeholder); pos != Aws::String::npos;
+         pos = expression.find(placeholder, pos + 1)) {
+        size_t end = pos + placeholder.size();
+        if (end == expression.size() || !(isalnum((unsigned char) expression[end]) || expression[end] == '_')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int aws_sdk_tcl_dynamodb_GetQueryRequest(
+        Tcl_Interp *interp,
+        const char *tableName,
+        Tcl_Obj *dictPtr,
+        Tcl_Obj *projectionExpressionPtr,
+        Tcl_Obj *scanForwardPtr,
+        Tcl_Obj *limitPtr,
+        Tcl_Obj *indexNamePtr,
+        const aws_sdk_tcl_dynamodb_query_options_t *options,
+        Aws::DynamoDB::Model::QueryRequest &request,
+        int *limit
+) {
+    request.SetTableName(tableName);
+    if (projectionExpressionPtr) {
+        Tcl_Size projectionExpressionLength;
+        const char *projectionExpression = Tcl_GetStringFromObj(projectionExpressionPtr, &projectionExpressionLength);
+        if (projectionExpressionLength > 0) {
+            request.SetProjectionExpression(projectionExpression);
+        }
+    }
+    if (scanForwardPtr) {
+        int scanForward;
+        if (TCL_OK != Tcl_GetBooleanFromObj(interp, scanForwardPtr, &scanForward)) {
+            return TCL_ERROR;
+        }
+        request.SetScanIndexForward(scanForward);
+    }
+    *limit = 0;
+    if (limitPtr) {
+        if (TCL_OK != Tcl_GetIntFromObj(interp, limitPtr, limit)) {
+            return TCL_ERROR;
+        }
+        if (*limit < 0) {
+            *limit = 0;
+        }
+        if (*limit > 0) {
+            request.SetLimit(*limit);
+        }
+    }
+    if (indexNamePtr) {
+        request.SetIndexName(Tcl_GetString(indexNamePtr));
+    }
+
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> attributeValues;
+    Aws::String keyConditionExpression;
+    // with an explicit key condition, the attributes of the query dict
+    // are only passed as values when an expression refers to them, the
+    // service rejects the values that are not used
+    Aws::String expressions;
+    if (options->keyConditionPtr) {
+        expressions.append(Tcl_GetString(options->keyConditionPtr));
+    }
+    if (options->filterPtr) {
+        expressions.append(" ").append(Tcl_GetString(options->filterPtr));
+    }
+
+    Tcl_DictSearch search;
+    Tcl_Obj *key, *spec;
+    int done;
+    if (Tcl_DictObjFirst(interp, dictPtr, &search,
+                         &key, &spec, &done) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    for (; !done; Tcl_DictObjNext(&search, &key, &spec, &done)) {
+        Tcl_Size length;
+        Tcl_ListObjLength(interp, spec, &length);
+        if (length != 2) {
+            Tcl_DictObjDone(&search);
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("Invalid attribute value", -1));
+            return TCL_ERROR;
+        }
+        Aws::String attribute_key = Tcl_GetString(key);
+        DBG(fprintf(stderr, "key=%s spec=%s\n", attribute_key.c_str(), Tcl_GetString(spec)));
+        if (options->keyConditionPtr && !aws_sdk_tcl_dynamodb_ExpressionUses(expressions, ":" + attribute_key)) {
+            continue;
+        }
+        auto entry = attributeValues.emplace(std::piecewise_construct,
+                                             std::forward_as_tuple(":" + attribute_key),
+                                             std::forward_as_tuple());
+        if (TCL_OK != aws_sdk_tcl_dynamodb_SetAttributeValue(interp, spec, entry.first->second)) {
+            Tcl_DictObjDone(&search);
+            return TCL_ERROR;
+        }
+
+        if (keyConditionExpression.length() > 0) {
+            keyConditionExpression.append(" AND ");
+        }
+        keyConditionExpression.append(attribute_key);
+        keyConditionExpression.append(" = :");
+        keyConditionExpression.append(attribute_key);
+    }
+    Tcl_DictObjDone(&search);
+
+    if (options->valuesPtr) {
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> values;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, options->valuesPtr, values)) {
+            return TCL_ERROR;
+        }
+        for (auto &value: values) {
+            attributeValues[value.first] = value.second;
+        }
+    }
+    if (options->namesPtr) {
+        Aws::Map<Aws::String, Aws::String> names;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeNames(interp, options->namesPtr, names)) {
+            return TCL_ERROR;
+        }
+        if (!names.empty()) {
+            request.SetExpressionAttributeNames(names);
+        }
+    }
+    if (options->keyConditionPtr) {
+        keyConditionExpression = Tcl_GetString(options->keyConditionPtr);
+    }
+    if (options->filterPtr) {
+        request.SetFilterExpression(Tcl_GetString(options->filterPtr));
+    }
+
+    request.SetKeyConditionExpression(keyConditionExpression);
+    if (!attributeValues.empty()) {
+        request.SetExpressionAttributeValues(std::move(attributeValues));
+    }
+    return TCL_OK;
+}
+
+int aws_sdk_tcl_dynamodb_QueryItems(
+        Tcl_Interp *interp,
+        Tcl_Obj *handlePtr,
+        const char *tableName,
+        Tcl_Obj *dictPtr,
+        Tcl_Obj *projectionExpressionPtr,
+        Tcl_Obj *scanForwardPtr,
+        Tcl_Obj *limitPtr,
+        Tcl_Obj *indexNamePtr,
+        const aws_sdk_tcl_dynamodb_query_options_t *options
+) {
+
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_QueryItems: handle=%s tableName=%s dict=%s\n", Tcl_GetString(handlePtr), tableName,
+                Tcl_GetString(dictPtr)));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+
+    Aws::DynamoDB::Model::QueryRequest request;
+    int limit;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetQueryRequest(interp, tableName, dictPtr, projectionExpressionPtr, scanForwardPtr,
+                                                       limitPtr, indexNamePtr, options, request, &limit)) {
+        return TCL_ERROR;
+    }
+
+    Tcl_Obj *resultListPtr = Tcl_NewListObj(0, nullptr);
+    int count = 0;
+
+    // "exclusiveStartKey" is used for pagination.
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> exclusiveStartKey;
+    do {
+        if (!exclusiveStartKey.empty()) {
+            request.SetExclusiveStartKey(exclusiveStartKey);
+            exclusiveStartKey.clear();
+        }
+        if (limit > 0) {
+            // no more than the items still missing
+            request.SetLimit(limit - count);
+        }
+        // Perform Query operation.
+        const Aws::DynamoDB::Model::QueryOutcome &outcome = client->Query(request);
+        if (outcome.IsSuccess()) {
+            // Reference the retrieved items.
+            const Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> &items = outcome.GetResult().GetItems();
+            if (!items.empty()) {
+                for (const auto &item: items) {
+                    // Output each retrieved field and its value.
+                    Tcl_Obj *itemDictPtr = Tcl_NewDictObj();
+                    for (const auto &i: item) {
+                        Tcl_DictObjPut(interp, itemDictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                                       get_typed_obj_from_attribute_value(interp, i.second));
+                    }
+                    Tcl_ListObjAppendElement(interp, resultListPtr, itemDictPtr);
+                    count++;
+                }
+            }
+
+            // If LastEvaluatedKey presents in the output, it means there are more items
+            exclusiveStartKey = outcome.GetResult().GetLastEvaluatedKey();
+        } else {
+            Tcl_DecrRefCount(resultListPtr);
+            aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
+            return TCL_ERROR;
+        }
+    } while (!exclusiveStartKey.empty() && (limit == 0 || count < limit));
+
+    Tcl_SetObjResult(interp, resultListPtr);
+    return TCL_OK;
+}
+
+// A query whose pages are fetched one at a time, with the next page
+// requested as soon as the current one arrives. When a page cannot be
+// fetched, the items that next had collected are held for the next call,
+// which requests the page again.
+typedef struct {
+    Tcl_Obj *handlePtr;
+    Aws::DynamoDB::Model::QueryRequest request;
+    int limit;
+    Tcl_WideInt returned;
+    Tcl_Obj *heldPtr;
+    bool failed;
+    Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> items;
+    size_t position;
+    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> lastKey;
+    Aws::DynamoDB::Model::QueryOutcomeCallable next;
+    bool pending;
+} aws_sdk_tcl_dynamodb_cursor_t;
+
+static int
+aws_sdk_tcl_dynamodb_CursorPrefetch(Tcl_Interp *interp, aws_sdk_tcl_dynamodb_cursor_t *cursor) {
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(cursor->handlePtr);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+    if (cursor->limit > 0) {
+        cursor->request.SetLimit((int) (cursor->limit - cursor->returned - (Tcl_WideInt) (cursor->items.size() - cursor->position)));
+    }
+    cursor->next = client->QueryCallable(cursor->request);
+    cursor->pending = true;
+    return TCL_OK;
+}
+
+// Waits for the page being fetched and, unless it is the last one or the
+// limit is reached with it, requests the one after it.
+static int
+aws_sdk_tcl_dynamodb_CursorFetch(Tcl_Interp *interp, aws_sdk_tcl_dynamodb_cursor_t *cursor) {
+    Aws::DynamoDB::Model::QueryOutcome outcome = cursor->next.get();
+    cursor->pending = false;
+    if (!outcome.IsSuccess()) {
+        cursor->failed = true;
+        return aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
+    }
+    cursor->items = outcome.GetResult().GetItems();
+    cursor->position = 0;
+    cursor->lastKey = outcome.GetResult().GetLastEvaluatedKey();
+    if (cursor->lastKey.empty()
+        || (cursor->limit > 0 && cursor->returned + (Tcl_WideInt) cursor->items.size() >= cursor->limit)) {
+        return TCL_OK;
+    }
+    cursor->request.SetExclusiveStartKey(cursor->lastKey);
+    return aws_sdk_tcl_dynamodb_CursorPrefetch(interp, cursor);
+}
+
+static void aws_sdk_tcl_dynamodb_CursorDeleteProc(ClientData clientData) {
+    auto *cursor = (aws_sdk_tcl_dynamodb_cursor_t *) clientData;
+    // the page in flight references the client
+    if (cursor->pending) {
+        cursor->next.wait();
+    }
+    if (cursor->heldPtr) {
+        Tcl_DecrRefCount(cursor->heldPtr);
+    }
+    Tcl_DecrRefCount(cursor->handlePtr);
+    delete cursor;
+}
+
+static int aws_sdk_tcl_dynamodb_CursorObjCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    static const char *cursorMethods[] = {
+            "next",
+            "last_key",
+            "close",
+            nullptr
+    };
 
-    request.SetKeyConditionExpression(keyConditionExpression);
-    request.SetExpressionAttributeValues(attributeValues);
+    enum cursorMethod {
+        m_next,
+        m_lastKey,
+        m_close
+    };
 
-    Tcl_Obj *resultListPtr = Tcl_NewListObj(0, nullptr);
-    int count = 0;
+    CheckArgs(2, 3, 1, "next ?n? | last_key | close");
+    auto *cursor = (aws_sdk_tcl_dynamodb_cursor_t *) clientData;
 
-    // "exclusiveStartKey" is used for pagination.
-    Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> exclusiveStartKey;
-    do {
-        if (!exclusiveStartKey.empty()) {
-            request.SetExclusiveStartKey(exclusiveStartKey);
-            exclusiveStartKey.clear();
-        }
-        // Perform Query operation.
-        const Aws::DynamoDB::Model::QueryOutcome &outcome = client->Query(request);
-        if (outcome.IsSuccess()) {
-            // Reference the retrieved items.
-            const Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> &items = outcome.GetResult().GetItems();
-            if (!items.empty()) {
-                for (const auto &item: items) {
-                    // Output each retrieved field and its value.
-                    Tcl_Obj *itemDictPtr = Tcl_NewDictObj();
-                    for (const auto &i: item) {
-                        Tcl_DictObjPut(interp, itemDictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
-                                       get_typed_obj_from_attribute_value(interp, i.second));
-                        count++;
+    int methodIndex;
+    if (TCL_OK != Tcl_GetIndexFromObj(interp, objv[1], cursorMethods, "method", 0, &methodIndex)) {
+        return TCL_ERROR;
+    }
+    switch ((enum cursorMethod) methodIndex) {
+        case m_next: {
+            // without n, the rest of the current page or the next page
+            int n = -1;
+            if (objc == 3) {
+                if (TCL_OK != Tcl_GetIntFromObj(interp, objv[2], &n)) {
+                    return TCL_ERROR;
+                }
+                if (n < 0) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("n: non-negative integer expected", -1));
+                    return TCL_ERROR;
+                }
+            }
+            // the items held by a call that failed come first
+            Tcl_Obj *resultListPtr = cursor->heldPtr;
+            cursor->heldPtr = nullptr;
+            if (!resultListPtr) {
+                resultListPtr = Tcl_NewListObj(0, nullptr);
+                Tcl_IncrRefCount(resultListPtr);
+            }
+            Tcl_Size length;
+            Tcl_ListObjLength(interp, resultListPtr, &length);
+            if (n >= 0 && length > n) {
+                Tcl_Obj **elements;
+                Tcl_ListObjGetElements(interp, resultListPtr, &length, &elements);
+                cursor->heldPtr = Tcl_NewListObj(length - n, elements + n);
+                Tcl_IncrRefCount(cursor->heldPtr);
+                Tcl_SetObjResult(interp, Tcl_NewListObj(n, elements));
+                Tcl_DecrRefCount(resultListPtr);
+                return TCL_OK;
+            }
+            if (cursor->failed) {
+                // the page that could not be fetched is requested again
+                if (TCL_OK != aws_sdk_tcl_dynamodb_CursorPrefetch(interp, cursor)) {
+                    cursor->heldPtr = resultListPtr;
+                    return TCL_ERROR;
+                }
+                cursor->failed = false;
+            }
+            while (n < 0 || length < n) {
+                if (cursor->limit > 0 && cursor->returned >= cursor->limit) {
+                    break;
+                }
+                if (cursor->position == cursor->items.size()) {
+                    if (!cursor->pending || (n < 0 && length > 0)) {
+                        break;
                     }
-                    Tcl_ListObjAppendElement(interp, resultListPtr, itemDictPtr);
+                    if (TCL_OK != aws_sdk_tcl_dynamodb_CursorFetch(interp, cursor)) {
+                        cursor->heldPtr = resultListPtr;
+                        return TCL_ERROR;
+                    }
+                    continue;
+                }
+                Tcl_Obj *itemDictPtr = Tcl_NewDictObj();
+                for (const auto &i: cursor->items[cursor->position]) {
+                    Tcl_DictObjPut(interp, itemDictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                                   get_typed_obj_from_attribute_value(interp, i.second));
                 }
+                Tcl_ListObjAppendElement(interp, resultListPtr, itemDictPtr);
+                cursor->position++;
+                cursor->returned++;
+                length++;
             }
-
-            // If LastEvaluatedKey presents in the output, it means there are more items
-            exclusiveStartKey = outcome.GetResult().GetLastEvaluatedKey();
-        } else {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
-            return TCL_ERROR;
+            if (cursor->position == cursor->items.size()) {
+                // the consumed page is not kept around
+                Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>>().swap(cursor->items);
+                cursor->position = 0;
+            }
+            Tcl_SetObjResult(interp, resultListPtr);
+            Tcl_DecrRefCount(resultListPtr);
+            return TCL_OK;
         }
-    } while (!exclusiveStartKey.empty() && (limitPtr == nullptr || count < limit));
+        case m_lastKey: {
+            CheckArgs(2, 2, 1, "last_key");
+            Tcl_Obj *lastKeyPtr = Tcl_NewDictObj();
+            for (const auto &i: cursor->lastKey) {
+                Tcl_DictObjPut(interp, lastKeyPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                               get_typed_obj_from_attribute_value(interp, i.second));
+            }
+            Tcl_SetObjResult(interp, lastKeyPtr);
+            return TCL_OK;
+        }
+        case m_close:
+            CheckArgs(2, 2, 1, "close");
+            Tcl_DeleteCommandFromToken(interp, Tcl_GetCommandFromObj(interp, objv[0]));
+            return TCL_OK;
+    }
+    return TCL_OK;
+}
 
-    Tcl_SetObjResult(interp, resultListPtr);
+// Starts a query and returns a cursor command over its items. The first
+// page is requested right away; every page after that is requested as
+// soon as the previous one arrives, so at most two pages are held.
+int aws_sdk_tcl_dynamodb_QueryCursor(
+        Tcl_Interp *interp,
+        Tcl_Obj *handlePtr,
+        const char *tableName,
+        Tcl_Obj *dictPtr,
+        Tcl_Obj *projectionExpressionPtr,
+        Tcl_Obj *scanForwardPtr,
+        Tcl_Obj *limitPtr,
+        Tcl_Obj *indexNamePtr,
+        const aws_sdk_tcl_dynamodb_query_options_t *options
+) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_QueryCursor: handle=%s tableName=%s dict=%s\n", Tcl_GetString(handlePtr), tableName,
+                Tcl_GetString(dictPtr)));
+    auto *cursor = new aws_sdk_tcl_dynamodb_cursor_t();
+    cursor->handlePtr = Tcl_NewStringObj(Tcl_GetString(handlePtr), -1);
+    Tcl_IncrRefCount(cursor->handlePtr);
+    cursor->returned = 0;
+    cursor->heldPtr = nullptr;
+    cursor->failed = false;
+    cursor->position = 0;
+    cursor->pending = false;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetQueryRequest(interp, tableName, dictPtr, projectionExpressionPtr, scanForwardPtr,
+                                                       limitPtr, indexNamePtr, options, cursor->request, &cursor->limit)
+        || TCL_OK != aws_sdk_tcl_dynamodb_CursorPrefetch(interp, cursor)) {
+        aws_sdk_tcl_dynamodb_CursorDeleteProc(cursor);
+        return TCL_ERROR;
+    }
+
+    char name[80];
+    std::sprintf(name, "_AWS_DDB_CURSOR_%p", cursor);
+    Tcl_CreateObjCommand(interp, name,
+                         (Tcl_ObjCmdProc *) aws_sdk_tcl_dynamodb_CursorObjCmd,
+                         cursor,
+                         (Tcl_CmdDeleteProc *) aws_sdk_tcl_dynamodb_CursorDeleteProc);
+
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(name, -1));
     return TCL_OK;
 }
 
@@ -559,16 +1754,147 @@ Aws::DynamoDB::Model::KeyType get_key_type(const char *type) {
     }
 }
 
+typedef struct {
+    Tcl_Obj *projectionPtr;
+    int segments;
+    int concurrency;
+    Tcl_Obj *cmdPtr;
+    int limit;
+    Tcl_Obj *filterPtr;
+    Tcl_Obj *expressionValuesPtr;
+    Tcl_Obj *exclusiveStartKeyPtr;
+} aws_sdk_tcl_dynamodb_scan_options_t;
+
+// Parses "?projection_expression? ?-option value ...?", the arguments of
+// scan after the table name.
+static int
+aws_sdk_tcl_dynamodb_GetScanOptions(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], aws_sdk_tcl_dynamodb_scan_options_t *options) {
+    static const char *const optionNames[] = {
+            "-segments", "-concurrency", "-command", "-limit", "-filter", "-expression-values", "-exclusive-start-key", NULL
+    };
+    enum optionNames {
+        OPT_SEGMENTS, OPT_CONCURRENCY, OPT_COMMAND, OPT_LIMIT, OPT_FILTER, OPT_EXPRESSION_VALUES, OPT_EXCLUSIVE_START_KEY
+    };
+
+    options->projectionPtr = nullptr;
+    options->segments = 1;
+    options->concurrency = 4;
+    options->cmdPtr = nullptr;
+    options->limit = 0;
+    options->filterPtr = nullptr;
+    options->expressionValuesPtr = nullptr;
+    options->exclusiveStartKeyPtr = nullptr;
+
+    int i = 0;
+    if (objc > 0 && Tcl_GetString(objv[0])[0] != '-') {
+        options->projectionPtr = objv[0];
+        i++;
+    }
+    for (; i < objc; i++) {
+        int option;
+        if (Tcl_GetIndexFromObj(interp, objv[i], optionNames, "option", 0, &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (++i == objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("missing value for option \"%s\"", Tcl_GetString(objv[i - 1])));
+            return TCL_ERROR;
+        }
+        switch ((enum optionNames) option) {
+            case OPT_SEGMENTS:
+                if (Tcl_GetIntFromObj(interp, objv[i], &options->segments) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                // the most segments DynamoDB accepts
+                if (options->segments <= 0 || options->segments > 1000000) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("-segments: integer between 1 and 1000000 expected", -1));
+                    return TCL_ERROR;
+                }
+                break;
+            case OPT_CONCURRENCY:
+                if (Tcl_GetIntFromObj(interp, objv[i], &options->concurrency) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                if (options->concurrency <= 0) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("-concurrency: positive integer expected", -1));
+                    return TCL_ERROR;
+                }
+                break;
+            case OPT_COMMAND:
+                options->cmdPtr = objv[i];
+                break;
+            case OPT_LIMIT:
+                if (Tcl_GetIntFromObj(interp, objv[i], &options->limit) != TCL_OK) {
+                    return TCL_ERROR;
+                }
+                if (options->limit <= 0) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("-limit: positive integer expected", -1));
+                    return TCL_ERROR;
+                }
+                break;
+            case OPT_FILTER:
+                options->filterPtr = objv[i];
+                break;
+            case OPT_EXPRESSION_VALUES:
+                options->expressionValuesPtr = objv[i];
+                break;
+            case OPT_EXCLUSIVE_START_KEY:
+                options->exclusiveStartKeyPtr = objv[i];
+                break;
+        }
+    }
+    if (options->exclusiveStartKeyPtr && options->segments > 1) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("-exclusive-start-key: not supported with more than one segment", -1));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+static Tcl_Obj *
+aws_sdk_tcl_dynamodb_ItemsToList(Tcl_Interp *interp, const Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> &items) {
+    Tcl_Obj *listPtr = Tcl_NewListObj(0, nullptr);
+    for (const Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &itemMap: items) {
+        Tcl_Obj *itemDictPtr = Tcl_NewDictObj();
+        for (const auto &i: itemMap) {
+            Tcl_DictObjPut(interp, itemDictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                           get_typed_obj_from_attribute_value(interp, i.second));
+        }
+        Tcl_ListObjAppendElement(interp, listPtr, itemDictPtr);
+    }
+    return listPtr;
+}
+
+static int
+aws_sdk_tcl_dynamodb_InvokeScanCmd(Tcl_Interp *interp, Tcl_Obj *cmdPtr, Tcl_Obj *itemsPtr, int segment, Tcl_Obj *lastKeyPtr) {
+    Tcl_Obj *evalPtr = Tcl_DuplicateObj(cmdPtr);
+    Tcl_IncrRefCount(evalPtr);
+    Tcl_ListObjAppendElement(interp, evalPtr, itemsPtr);
+    Tcl_ListObjAppendElement(interp, evalPtr, Tcl_NewIntObj(segment));
+    Tcl_ListObjAppendElement(interp, evalPtr, lastKeyPtr);
+    int rc = Tcl_EvalObjEx(interp, evalPtr, TCL_EVAL_GLOBAL);
+    Tcl_DecrRefCount(evalPtr);
+    return rc;
+}
+
+// Scans a table, following LastEvaluatedKey until every page has been
+// read. With more than one segment, up to "concurrency" segments are
+// scanned in parallel on the client executor, the next one starting as
+// soon as one of them is done. The items of every page are either merged into
+// the list returned or, with a command, handed to it as "cmd items segment
+// last_key" as soon as they arrive, in which case the number of items
+// delivered is returned. The last key of a page, empty on the last one,
+// can be passed back as -exclusive-start-key to resume the scan. The
+// command may break to stop the scan; the next page of a segment is only
+// requested once it returns, with the client looked up again since the
+// command may have destroyed the handle.
 int aws_sdk_tcl_dynamodb_Scan(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *tableName,
-        Tcl_Obj *projectionExpressionPtr
+        const aws_sdk_tcl_dynamodb_scan_options_t *options
 ) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_Scan: handle=%s tableName=%s projection_expression_dict=%s\n", handle,
-                tableName,
-                Tcl_GetString(projectionExpressionPtr)));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_Scan: handle=%s tableName=%s segments=%d\n", Tcl_GetString(handlePtr),
+                tableName, options->segments));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -577,46 +1903,136 @@ int aws_sdk_tcl_dynamodb_Scan(
     Aws::DynamoDB::Model::ScanRequest request;
     request.SetTableName(tableName);
 
+    if (options->projectionPtr)
+        request.SetProjectionExpression(Tcl_GetString(options->projectionPtr));
+
+    if (options->limit > 0)
+        request.SetLimit(options->limit);
+
+    if (options->filterPtr)
+        request.SetFilterExpression(Tcl_GetString(options->filterPtr));
+
+    if (options->expressionValuesPtr) {
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> expressionValues;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, options->expressionValuesPtr, expressionValues)) {
+            return TCL_ERROR;
+        }
+        request.SetExpressionAttributeValues(std::move(expressionValues));
+    }
+
+    if (options->exclusiveStartKeyPtr) {
+        Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> exclusiveStartKey;
+        if (TCL_OK != aws_sdk_tcl_dynamodb_GetAttributeMap(interp, options->exclusiveStartKeyPtr, exclusiveStartKey)) {
+            return TCL_ERROR;
+        }
+        if (!exclusiveStartKey.empty()) {
+            request.SetExclusiveStartKey(exclusiveStartKey);
+        }
+    }
 
-    if (projectionExpressionPtr)
-        request.SetProjectionExpression(Tcl_GetString(projectionExpressionPtr));
+    // the request of every segment being scanned, for the next page to
+    // reuse, and the next segment to start
+    Aws::Map<int, Aws::DynamoDB::Model::ScanRequest> requests;
+    int nextSegment = 0;
+    std::deque<std::pair<int, Aws::DynamoDB::Model::ScanOutcomeCallable>> inflight;
 
-    // Perform scan on table.
-    const Aws::DynamoDB::Model::ScanOutcome &outcome = client->Scan(request);
     Tcl_Obj *resultListPtr = Tcl_NewListObj(0, nullptr);
-    if (outcome.IsSuccess()) {
-        // Reference the retrieved items.
+    Tcl_IncrRefCount(resultListPtr);
+    Tcl_WideInt count = 0;
+    int rc = TCL_OK;
+    for (;;) {
+        // a segment has one page in flight at most until it is done
+        while (rc == TCL_OK && client && nextSegment < options->segments && inflight.size() < (size_t) options->concurrency) {
+            int segment = nextSegment++;
+            Aws::DynamoDB::Model::ScanRequest &segmentRequest = requests.emplace(segment, request).first->second;
+            if (options->segments > 1) {
+                segmentRequest.SetSegment(segment);
+                segmentRequest.SetTotalSegments(options->segments);
+            }
+            inflight.emplace_back(segment, client->ScanCallable(segmentRequest));
+        }
+        if (inflight.empty()) {
+            break;
+        }
+        int segment = inflight.front().first;
+        Aws::DynamoDB::Model::ScanOutcome outcome = inflight.front().second.get();
+        inflight.pop_front();
+        if (rc != TCL_OK) {
+            // the pages in flight are awaited before returning
+            continue;
+        }
+        if (!outcome.IsSuccess()) {
+            aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
+            rc = TCL_ERROR;
+            continue;
+        }
         const Aws::Vector<Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue>> &items = outcome.GetResult().GetItems();
-        if (!items.empty()) {
-            for (const Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &itemMap: items) {
-                Tcl_Obj *itemDictPtr = Tcl_NewDictObj();
-                for (const auto &i: itemMap) {
-                    Tcl_DictObjPut(interp, itemDictPtr, Tcl_NewStringObj(i.first.c_str(), -1),
-                                   get_typed_obj_from_attribute_value(interp, i.second));
-                }
-                Tcl_ListObjAppendElement(interp, resultListPtr, itemDictPtr);
+        const Aws::Map<Aws::String, Aws::DynamoDB::Model::AttributeValue> &lastKey = outcome.GetResult().GetLastEvaluatedKey();
+        if (lastKey.empty()) {
+            requests.erase(segment);
+        } else {
+            requests[segment].SetExclusiveStartKey(lastKey);
+            if (!options->cmdPtr) {
+                // the next page is on its way while this one is handled
+                inflight.emplace_back(segment, client->ScanCallable(requests[segment]));
             }
         }
+        Tcl_Obj *itemsPtr = aws_sdk_tcl_dynamodb_ItemsToList(interp, items);
+        Tcl_IncrRefCount(itemsPtr);
+        int cmdRc = TCL_OK;
+        if (options->cmdPtr) {
+            Tcl_Obj *lastKeyPtr = Tcl_NewDictObj();
+            for (const auto &i: lastKey) {
+                Tcl_DictObjPut(interp, lastKeyPtr, Tcl_NewStringObj(i.first.c_str(), -1),
+                               get_typed_obj_from_attribute_value(interp, i.second));
+            }
+            count += (Tcl_WideInt) items.size();
+            cmdRc = aws_sdk_tcl_dynamodb_InvokeScanCmd(interp, options->cmdPtr, itemsPtr, segment, lastKeyPtr);
+            // the command may have destroyed the handle
+            client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
+            if (cmdRc == TCL_OK && !client) {
+                Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+                cmdRc = TCL_ERROR;
+            }
+            if (cmdRc == TCL_OK && !lastKey.empty()) {
+                inflight.emplace_back(segment, client->ScanCallable(requests[segment]));
+            }
+        } else {
+            Tcl_ListObjAppendList(interp, resultListPtr, itemsPtr);
+        }
+        Tcl_DecrRefCount(itemsPtr);
+        if (cmdRc == TCL_BREAK) {
+            rc = TCL_BREAK;
+        } else if (cmdRc == TCL_ERROR || cmdRc == TCL_RETURN) {
+            rc = cmdRc;
+        }
+    }
+    if (rc != TCL_OK && rc != TCL_BREAK) {
+        Tcl_DecrRefCount(resultListPtr);
+        return rc;
+    }
+
+    if (options->cmdPtr) {
+        Tcl_SetObjResult(interp, Tcl_NewWideIntObj(count));
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
-        return TCL_ERROR;
+        Tcl_SetObjResult(interp, resultListPtr);
     }
-    Tcl_SetObjResult(interp, resultListPtr);
+    Tcl_DecrRefCount(resultListPtr);
     return TCL_OK;
 
 }
 
 int aws_sdk_tcl_dynamodb_CreateTable(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *tableName,
         Tcl_Obj *keySchemaDictPtr,
         Tcl_Obj *provisionedThroughputDictPtr,
         Tcl_Obj *globalSecondaryIndexesListPtr
 ) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_CreateTable: handle=%s tableName=%s dict=%s\n", handle, tableName,
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_CreateTable: handle=%s tableName=%s dict=%s\n", Tcl_GetString(handlePtr), tableName,
                 Tcl_GetString(keySchemaDictPtr)));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -805,14 +2221,14 @@ int aws_sdk_tcl_dynamodb_CreateTable(
         Tcl_SetObjResult(interp, Tcl_NewBooleanObj(true));
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
-int aws_sdk_tcl_dynamodb_DeleteTable(Tcl_Interp *interp, const char *handle, const char *tableName) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_DeleteTable: handle=%s tableName=%s\n", handle, tableName));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+int aws_sdk_tcl_dynamodb_DeleteTable(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *tableName) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_DeleteTable: handle=%s tableName=%s\n", Tcl_GetString(handlePtr), tableName));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -827,14 +2243,14 @@ int aws_sdk_tcl_dynamodb_DeleteTable(Tcl_Interp *interp, const char *handle, con
         Tcl_SetObjResult(interp, Tcl_NewBooleanObj(true));
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
-int aws_sdk_tcl_dynamodb_ListTables(Tcl_Interp *interp, const char *handle) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_ListTables: handle=%s\n", handle));
-    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromName(handle);
+int aws_sdk_tcl_dynamodb_ListTables(Tcl_Interp *interp, Tcl_Obj *handlePtr) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_dynamodb_ListTables: handle=%s\n", Tcl_GetString(handlePtr)));
+    Aws::DynamoDB::DynamoDBClient *client = aws_sdk_tcl_dynamodb_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -846,7 +2262,7 @@ int aws_sdk_tcl_dynamodb_ListTables(Tcl_Interp *interp, const char *handle) {
     do {
         const Aws::DynamoDB::Model::ListTablesOutcome &outcome = client->ListTables(listTablesRequest);
         if (!outcome.IsSuccess()) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+            aws_sdk_tcl_SetErrorResult(interp, "DynamoDB", outcome.GetError());
             return TCL_ERROR;
         }
 
@@ -966,7 +2382,12 @@ int aws_sdk_tcl_dynamodb_ClientObjCmd(ClientData clientData, Tcl_Interp *interp,
             "put_item",
             "get_item",
             "delete_item",
+            "batch_write",
+            "batch_get",
+            "transact_write",
+            "transact_get",
             "query_items",
+            "query_cursor",
             "scan",
             "update_item",
             "create_table",
@@ -980,7 +2401,12 @@ int aws_sdk_tcl_dynamodb_ClientObjCmd(ClientData clientData, Tcl_Interp *interp,
         m_putItem,
         m_getItem,
         m_deleteItem,
+        m_batchWrite,
+        m_batchGet,
+        m_transactWrite,
+        m_transactGet,
         m_queryItems,
+        m_queryCursor,
         m_scan,
         m_updateItem,
         m_createTable,
@@ -999,62 +2425,168 @@ int aws_sdk_tcl_dynamodb_ClientObjCmd(ClientData clientData, Tcl_Interp *interp,
     if (TCL_OK == Tcl_GetIndexFromObj(interp, objv[1], clientMethods, "method", 0, &methodIndex)) {
         Tcl_ResetResult(interp);
         const char *handle = Tcl_GetString(objv[0]);
+        aws_sdk_tcl_HandleObj handleObj(clientData);
+        Tcl_Obj *handlePtr = handleObj.objPtr;
         switch ((enum clientMethod) methodIndex) {
             case m_destroy:
                 return aws_sdk_tcl_dynamodb_Destroy(interp, handle);
-            case m_putItem:
-                CheckArgs(4, 4, 1, "put_item table item_dict");
+            case m_putItem: {
+                CheckArgs(4, 12, 1, "put_item table item_dict ?-condition expression? ?-names dict? ?-values dict? ?-return value?");
+                aws_sdk_tcl_dynamodb_write_options_t options;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetWriteOptions(interp, objc - 4, objv + 4, &options)) {
+                    return TCL_ERROR;
+                }
                 return aws_sdk_tcl_dynamodb_PutItem(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
-                        objv[3]
+                        objv[3],
+                        &options
                 );
+            }
             case m_getItem:
                 CheckArgs(4, 4, 1, "get_item table key_dict");
                 return aws_sdk_tcl_dynamodb_GetItem(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objv[3]
                 );
-            case m_deleteItem:
-                CheckArgs(4, 4, 1, "delete_item table key_dict");
+            case m_deleteItem: {
+                CheckArgs(4, 12, 1, "delete_item table key_dict ?-condition expression? ?-names dict? ?-values dict? ?-return value?");
+                aws_sdk_tcl_dynamodb_write_options_t options;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetWriteOptions(interp, objc - 4, objv + 4, &options)) {
+                    return TCL_ERROR;
+                }
                 return aws_sdk_tcl_dynamodb_DeleteItem(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
-                        objv[3]
+                        objv[3],
+                        &options
+                );
+            }
+            case m_batchWrite: {
+                CheckArgs(4, 8, 1, "batch_write table items_list ?-deletes keys_list? ?-concurrency n?");
+                Tcl_Obj *deletesPtr;
+                int concurrency;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetBatchWriteOptions(interp, objc - 4, objv + 4, &deletesPtr, &concurrency)) {
+                    return TCL_ERROR;
+                }
+                return aws_sdk_tcl_dynamodb_BatchWrite(
+                        interp,
+                        handlePtr,
+                        Tcl_GetString(objv[2]),
+                        objv[3],
+                        deletesPtr,
+                        concurrency
+                );
+            }
+            case m_batchGet: {
+                CheckArgs(3, 9, 1, "batch_get table_keys_dict ?-projection expression? ?-consistent bool? ?-concurrency n?");
+                Tcl_Obj *projectionPtr;
+                int consistent, concurrency;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetBatchGetOptions(interp, objc - 3, objv + 3, &projectionPtr, &consistent, &concurrency)) {
+                    return TCL_ERROR;
+                }
+                return aws_sdk_tcl_dynamodb_BatchGet(
+                        interp,
+                        handlePtr,
+                        objv[2],
+                        projectionPtr,
+                        consistent,
+                        concurrency
+                );
+            }
+            case m_transactWrite:
+                CheckArgs(3, 5, 1, "transact_write ops_list ?-token client_request_token?");
+                if (objc == 4 || (objc == 5 && 0 != strcmp("-token", Tcl_GetString(objv[3])))) {
+                    Tcl_WrongNumArgs(interp, 1, objv, "transact_write ops_list ?-token client_request_token?");
+                    return TCL_ERROR;
+                }
+                return aws_sdk_tcl_dynamodb_TransactWrite(
+                        interp,
+                        handlePtr,
+                        objv[2],
+                        objc == 5 ? objv[4] : nullptr
                 );
-            case m_queryItems:
-                CheckArgs(4, 8, 1,
-                          "get_item table query_dict ?projection_expression? ?scan_forward? ?limit? ?index_name?");
+            case m_transactGet:
+                CheckArgs(3, 3, 1, "transact_get gets_list");
+                return aws_sdk_tcl_dynamodb_TransactGet(interp, handlePtr, objv[2]);
+            case m_queryItems: {
+                CheckArgs(4, 16, 1,
+                          "query_items table query_dict ?projection_expression? ?scan_forward? ?limit? ?index_name? ?-key-condition expression? ?-filter expression? ?-names dict? ?-values dict?");
+                aws_sdk_tcl_dynamodb_query_options_t options;
+                int positional;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetQueryOptions(interp, objc - 4, objv + 4, &positional, &options)) {
+                    return TCL_ERROR;
+                }
                 return aws_sdk_tcl_dynamodb_QueryItems(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objv[3],
-                        objc > 4 ? objv[4] : nullptr,
-                        objc > 5 ? objv[5] : nullptr,
-                        objc > 6 ? objv[6] : nullptr,
-                        objc > 7 ? objv[7] : nullptr
+                        positional > 0 ? objv[4] : nullptr,
+                        positional > 1 ? objv[5] : nullptr,
+                        positional > 2 ? objv[6] : nullptr,
+                        positional > 3 ? objv[7] : nullptr,
+                        &options
+                );
+            }
+            case m_queryCursor: {
+                CheckArgs(4, 16, 1,
+                          "query_cursor table query_dict ?projection_expression? ?scan_forward? ?limit? ?index_name? ?-key-condition expression? ?-filter expression? ?-names dict? ?-values dict?");
+                aws_sdk_tcl_dynamodb_query_options_t options;
+                int positional;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetQueryOptions(interp, objc - 4, objv + 4, &positional, &options)) {
+                    return TCL_ERROR;
+                }
+                return aws_sdk_tcl_dynamodb_QueryCursor(
+                        interp,
+                        handlePtr,
+                        Tcl_GetString(objv[2]),
+                        objv[3],
+                        positional > 0 ? objv[4] : nullptr,
+                        positional > 1 ? objv[5] : nullptr,
+                        positional > 2 ? objv[6] : nullptr,
+                        positional > 3 ? objv[7] : nullptr,
+                        &options
                 );
-            case m_scan:
-                CheckArgs(3, 4, 1, "scan table ?projection_expression?");
+            }
+            case m_scan: {
+                CheckArgs(3, 18, 1, "scan table ?projection_expression? ?-segments n? ?-concurrency n? ?-command cmd? ?-limit n? ?-filter expression? ?-expression-values dict? ?-exclusive-start-key key_dict?");
+                aws_sdk_tcl_dynamodb_scan_options_t options;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetScanOptions(interp, objc - 3, objv + 3, &options)) {
+                    return TCL_ERROR;
+                }
                 return aws_sdk_tcl_dynamodb_Scan(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
-                        objc > 3 ? objv[3] : nullptr
+                        &options
                 );
-            case m_updateItem:
-                break;
+            }
+            case m_updateItem: {
+                CheckArgs(5, 13, 1, "update_item table key_dict update_expression ?-condition expression? ?-names dict? ?-values dict? ?-return value?");
+                aws_sdk_tcl_dynamodb_write_options_t options;
+                if (TCL_OK != aws_sdk_tcl_dynamodb_GetWriteOptions(interp, objc - 5, objv + 5, &options)) {
+                    return TCL_ERROR;
+                }
+                return aws_sdk_tcl_dynamodb_UpdateItem(
+                        interp,
+                        handlePtr,
+                        Tcl_GetString(objv[2]),
+                        objv[3],
+                        objv[4],
+                        &options
+                );
+            }
             case m_createTable:
                 CheckArgs(4, 6, 1,
                           "create_table table key_schema_dict ?provisioned_throughput_dict? ?global_secondary_indexes_list?");
                 return aws_sdk_tcl_dynamodb_CreateTable(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objv[3],
                         objc > 4 ? objv[4] : nullptr,
@@ -1064,14 +2596,14 @@ int aws_sdk_tcl_dynamodb_ClientObjCmd(ClientData clientData, Tcl_Interp *interp,
                 CheckArgs(3, 3, 1, "delete_table table");
                 return aws_sdk_tcl_dynamodb_DeleteTable(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_listTables:
                 CheckArgs(2, 2, 1, "list_tables");
                 return aws_sdk_tcl_dynamodb_ListTables(
                         interp,
-                        handle
+                        handlePtr
                 );
         }
     }
@@ -1113,38 +2645,55 @@ char *aws_sdk_tcl_dynamodb_VarTraceProc(ClientData clientData, Tcl_Interp *inter
 static int aws_sdk_tcl_dynamodb_CreateCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "CreateCmd\n"));
 
-    CheckArgs(2, 3, 1, "config_dict ?varname?");
+    int shared = objc > 1 && 0 == strcmp(Tcl_GetString(objv[1]), "-shared");
+    CheckArgs(2 + shared, 3 + shared, 1, "?-shared? config_dict ?varname?");
 
-    auto result = get_client_config_and_credentials_provider(interp, objv[1]);
-    int status = std::get<0>(result);
-    if (TCL_OK != status) {
-        SetResult("Invalid config_dict");
-        return TCL_ERROR;
+    Aws::String key;
+    Aws::DynamoDB::DynamoDBClient *client = nullptr;
+    if (shared) {
+        if (TCL_OK != aws_sdk_tcl_GetSharedClientKey(interp, "dynamodb", objv[1 + shared], key)) {
+            return TCL_ERROR;
+        }
+        // the configuration and credentials are only set up for a new client
+        client = (Aws::DynamoDB::DynamoDBClient *) aws_sdk_tcl_FindSharedClient(key);
     }
-    Aws::Client::ClientConfiguration client_config = std::get<1>(result);
-    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+    if (!client) {
+        auto result = get_client_config_and_credentials_provider(interp, objv[1 + shared]);
+        int status = std::get<0>(result);
+        if (TCL_OK != status) {
+            return TCL_ERROR;
+        }
+        Aws::Client::ClientConfiguration client_config = std::get<1>(result);
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
 
-    auto *client = credentials_provider_ptr != nullptr ? new Aws::DynamoDB::DynamoDBClient(credentials_provider_ptr,
-                                                                                           client_config)
-                                                       : new Aws::DynamoDB::DynamoDBClient(client_config);
+        client = credentials_provider_ptr != nullptr ? new Aws::DynamoDB::DynamoDBClient(credentials_provider_ptr, client_config)
+                                                     : new Aws::DynamoDB::DynamoDBClient(client_config);
+        if (shared) {
+            client = (Aws::DynamoDB::DynamoDBClient *) aws_sdk_tcl_AddSharedClient(key, client, aws_sdk_tcl_dynamodb_DeleteClient);
+        }
+    }
     char handle[80];
-    CMD_NAME(handle, client);
-    aws_sdk_tcl_dynamodb_RegisterName(handle, client);
+    if (shared) {
+        SHARED_CMD_NAME(handle, client, aws_sdk_tcl_NewSharedHandleId());
+    } else {
+        CMD_NAME(handle, client);
+    }
+    ClientData handleRef = aws_sdk_tcl_dynamodb_RegisterName(handle, client);
 
     Tcl_CreateObjCommand(interp, handle,
                          (Tcl_ObjCmdProc *) aws_sdk_tcl_dynamodb_ClientObjCmd,
-                         nullptr,
-                         nullptr);
+                         handleRef,
+                         (Tcl_CmdDeleteProc *) aws_sdk_tcl_FreeHandleRef);
 //                                 (Tcl_CmdDeleteProc*) aws_sdk_tcl_dynamodb_clientObjCmdDeleteProc);
 
 
-    if (objc == 3) {
+    if (objc == 3 + shared) {
         auto *trace = (aws_sdk_tcl_dynamodb_trace_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_dynamodb_trace_t));
         trace->interp = interp;
-        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2]), 80);
+        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2 + shared]), 80);
         trace->handle = aws_sdk_strndup(handle, 80);
         trace->item = client;
-        const char *objVar = Tcl_GetString(objv[2]);
+        const char *objVar = Tcl_GetString(objv[2 + shared]);
         Tcl_UnsetVar(interp, objVar, 0);
         Tcl_SetVar  (interp, objVar, handle, 0);
         Tcl_TraceVar(interp,objVar,TCL_TRACE_WRITES|TCL_TRACE_UNSETS,
@@ -1164,46 +2713,136 @@ static int aws_sdk_tcl_dynamodb_DestroyCmd(ClientData clientData, Tcl_Interp *in
 
 static int aws_sdk_tcl_dynamodb_PutItemCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "PutItemCmd\n"));
-    CheckArgs(4, 4, 1, "handle_name table item_dict");
-    return aws_sdk_tcl_dynamodb_PutItem(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), objv[3]);
+    CheckArgs(4, 12, 1, "handle_name table item_dict ?-condition expression? ?-names dict? ?-values dict? ?-return value?");
+    aws_sdk_tcl_dynamodb_write_options_t options;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetWriteOptions(interp, objc - 4, objv + 4, &options)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_dynamodb_PutItem(interp, objv[1], Tcl_GetString(objv[2]), objv[3], &options);
 }
 
 static int aws_sdk_tcl_dynamodb_GetItemCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "GetItemCmd\n"));
     CheckArgs(4, 4, 1, "handle_name table key_dict");
-    return aws_sdk_tcl_dynamodb_GetItem(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), objv[3]);
+    return aws_sdk_tcl_dynamodb_GetItem(interp, objv[1], Tcl_GetString(objv[2]), objv[3]);
 }
 
 static int aws_sdk_tcl_dynamodb_DeleteItemCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "DeleteItemCmd\n"));
-    CheckArgs(4, 4, 1, "handle_name table key_dict");
-    return aws_sdk_tcl_dynamodb_DeleteItem(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), objv[3]);
+    CheckArgs(4, 12, 1, "handle_name table key_dict ?-condition expression? ?-names dict? ?-values dict? ?-return value?");
+    aws_sdk_tcl_dynamodb_write_options_t options;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetWriteOptions(interp, objc - 4, objv + 4, &options)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_dynamodb_DeleteItem(interp, objv[1], Tcl_GetString(objv[2]), objv[3], &options);
+}
+
+static int aws_sdk_tcl_dynamodb_UpdateItemCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    DBG(fprintf(stderr, "UpdateItemCmd\n"));
+    CheckArgs(5, 13, 1, "handle_name table key_dict update_expression ?-condition expression? ?-names dict? ?-values dict? ?-return value?");
+    aws_sdk_tcl_dynamodb_write_options_t options;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetWriteOptions(interp, objc - 5, objv + 5, &options)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_dynamodb_UpdateItem(interp, objv[1], Tcl_GetString(objv[2]), objv[3], objv[4], &options);
+}
+
+static int aws_sdk_tcl_dynamodb_BatchWriteCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    DBG(fprintf(stderr, "BatchWriteCmd\n"));
+    CheckArgs(4, 8, 1, "handle_name table items_list ?-deletes keys_list? ?-concurrency n?");
+    Tcl_Obj *deletesPtr;
+    int concurrency;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetBatchWriteOptions(interp, objc - 4, objv + 4, &deletesPtr, &concurrency)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_dynamodb_BatchWrite(interp, objv[1], Tcl_GetString(objv[2]), objv[3], deletesPtr, concurrency);
+}
+
+static int aws_sdk_tcl_dynamodb_BatchGetCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    DBG(fprintf(stderr, "BatchGetCmd\n"));
+    CheckArgs(3, 9, 1, "handle_name table_keys_dict ?-projection expression? ?-consistent bool? ?-concurrency n?");
+    Tcl_Obj *projectionPtr;
+    int consistent, concurrency;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetBatchGetOptions(interp, objc - 3, objv + 3, &projectionPtr, &consistent, &concurrency)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_dynamodb_BatchGet(interp, objv[1], objv[2], projectionPtr, consistent, concurrency);
+}
+
+static int aws_sdk_tcl_dynamodb_TransactWriteCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    DBG(fprintf(stderr, "TransactWriteCmd\n"));
+    CheckArgs(3, 5, 1, "handle_name ops_list ?-token client_request_token?");
+    if (objc == 4 || (objc == 5 && 0 != strcmp("-token", Tcl_GetString(objv[3])))) {
+        Tcl_WrongNumArgs(interp, 1, objv, "handle_name ops_list ?-token client_request_token?");
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_dynamodb_TransactWrite(interp, objv[1], objv[2], objc == 5 ? objv[4] : nullptr);
+}
+
+static int aws_sdk_tcl_dynamodb_TransactGetCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    DBG(fprintf(stderr, "TransactGetCmd\n"));
+    CheckArgs(3, 3, 1, "handle_name gets_list");
+    return aws_sdk_tcl_dynamodb_TransactGet(interp, objv[1], objv[2]);
 }
 
 static int
 aws_sdk_tcl_dynamodb_QueryItemsCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "QueryItemsCmd\n"));
-    CheckArgs(4, 8, 1, "handle_name table query_dict ?projection_expression? ?scan_forward? ?limit? ?index_name?");
+    CheckArgs(4, 16, 1,
+              "handle_name table query_dict ?projection_expression? ?scan_forward? ?limit? ?index_name? ?-key-condition expression? ?-filter expression? ?-names dict? ?-values dict?");
+    aws_sdk_tcl_dynamodb_query_options_t options;
+    int positional;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetQueryOptions(interp, objc - 4, objv + 4, &positional, &options)) {
+        return TCL_ERROR;
+    }
     return aws_sdk_tcl_dynamodb_QueryItems(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             objv[3],
-            objc > 4 ? objv[4] : nullptr,
-            objc > 5 ? objv[5] : nullptr,
-            objc > 6 ? objv[6] : nullptr,
-            objc > 7 ? objv[7] : nullptr
+            positional > 0 ? objv[4] : nullptr,
+            positional > 1 ? objv[5] : nullptr,
+            positional > 2 ? objv[6] : nullptr,
+            positional > 3 ? objv[7] : nullptr,
+            &options
+    );
+}
+
+static int
+aws_sdk_tcl_dynamodb_QueryCursorCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    DBG(fprintf(stderr, "QueryCursorCmd\n"));
+    CheckArgs(4, 16, 1,
+              "handle_name table query_dict ?projection_expression? ?scan_forward? ?limit? ?index_name? ?-key-condition expression? ?-filter expression? ?-names dict? ?-values dict?");
+    aws_sdk_tcl_dynamodb_query_options_t options;
+    int positional;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetQueryOptions(interp, objc - 4, objv + 4, &positional, &options)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_dynamodb_QueryCursor(
+            interp,
+            objv[1],
+            Tcl_GetString(objv[2]),
+            objv[3],
+            positional > 0 ? objv[4] : nullptr,
+            positional > 1 ? objv[5] : nullptr,
+            positional > 2 ? objv[6] : nullptr,
+            positional > 3 ? objv[7] : nullptr,
+            &options
     );
 }
 
 static int aws_sdk_tcl_dynamodb_ScanCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "CreateTableCmd\n"));
-    CheckArgs(3, 4, 1, "handle_name table ?projection_expression?");
+    CheckArgs(3, 18, 1, "handle_name table ?projection_expression? ?-segments n? ?-concurrency n? ?-command cmd? ?-limit n? ?-filter expression? ?-expression-values dict? ?-exclusive-start-key key_dict?");
+    aws_sdk_tcl_dynamodb_scan_options_t options;
+    if (TCL_OK != aws_sdk_tcl_dynamodb_GetScanOptions(interp, objc - 3, objv + 3, &options)) {
+        return TCL_ERROR;
+    }
     return aws_sdk_tcl_dynamodb_Scan(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
-            objc > 3 ? objv[3] : nullptr
+            &options
     );
 }
 
@@ -1214,7 +2853,7 @@ aws_sdk_tcl_dynamodb_CreateTableCmd(ClientData clientData, Tcl_Interp *interp, i
               "handle_name table key_schema_dict ?provisioned_throughput_dict? ?global_secondary_indexes_list?");
     return aws_sdk_tcl_dynamodb_CreateTable(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             objv[3],
             objc > 4 ? objv[4] : nullptr,
@@ -1226,14 +2865,14 @@ static int
 aws_sdk_tcl_dynamodb_DeleteTableCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "DeleteTableCmd\n"));
     CheckArgs(3, 3, 1, "handle_name table");
-    return aws_sdk_tcl_dynamodb_DeleteTable(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_dynamodb_DeleteTable(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int
 aws_sdk_tcl_dynamodb_ListTablesCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "ListTablesCmd\n"));
     CheckArgs(2, 2, 1, "handle_name");
-    return aws_sdk_tcl_dynamodb_ListTables(interp, Tcl_GetString(objv[1]));
+    return aws_sdk_tcl_dynamodb_ListTables(interp, objv[1]);
 }
 
 static int
@@ -1243,12 +2882,11 @@ aws_sdk_tcl_dynamodb_TypedItemToSimpleCmd(ClientData clientData, Tcl_Interp *int
     return aws_sdk_tcl_dynamodb_TypedItemToSimple(interp, objv[1]);
 }
 
-static Aws::SDKOptions options;
-
 static void aws_sdk_tcl_dynamodb_ExitHandler(ClientData unused) {
     Tcl_MutexLock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
     Tcl_DeleteHashTable(&aws_sdk_tcl_dynamodb_NameToInternal_HT);
-    Aws::ShutdownAPI(options);
+    aws_sdk_tcl_ShutdownAPI();
+    aws_sdk_tcl_dynamodb_ModuleInitialized = 0;
     Tcl_MutexUnlock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
 
 }
@@ -1257,7 +2895,7 @@ static void aws_sdk_tcl_dynamodb_ExitHandler(ClientData unused) {
 void aws_sdk_tcl_dynamodb_InitModule() {
     Tcl_MutexLock(&aws_sdk_tcl_dynamodb_NameToInternal_HT_Mutex);
     if (!aws_sdk_tcl_dynamodb_ModuleInitialized) {
-        Aws::InitAPI(options);
+        aws_sdk_tcl_InitAPI();
         Tcl_InitHashTable(&aws_sdk_tcl_dynamodb_NameToInternal_HT, TCL_STRING_KEYS);
         Tcl_CreateThreadExitHandler(aws_sdk_tcl_dynamodb_ExitHandler, nullptr);
         aws_sdk_tcl_dynamodb_ModuleInitialized = 1;
@@ -1281,12 +2919,19 @@ int Aws_sdk_tcl_dynamodb_Init(Tcl_Interp *interp) {
     aws_sdk_tcl_dynamodb_InitModule();
 
     Tcl_CreateNamespace(interp, "::aws::dynamodb", nullptr, nullptr);
+    aws_sdk_tcl_CreateCommonCmds(interp);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::create", aws_sdk_tcl_dynamodb_CreateCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::destroy", aws_sdk_tcl_dynamodb_DestroyCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::put_item", aws_sdk_tcl_dynamodb_PutItemCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::get_item", aws_sdk_tcl_dynamodb_GetItemCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::delete_item", aws_sdk_tcl_dynamodb_DeleteItemCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::dynamodb::update_item", aws_sdk_tcl_dynamodb_UpdateItemCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::dynamodb::batch_write", aws_sdk_tcl_dynamodb_BatchWriteCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::dynamodb::batch_get", aws_sdk_tcl_dynamodb_BatchGetCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::dynamodb::transact_write", aws_sdk_tcl_dynamodb_TransactWriteCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::dynamodb::transact_get", aws_sdk_tcl_dynamodb_TransactGetCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::query_items", aws_sdk_tcl_dynamodb_QueryItemsCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::dynamodb::query_cursor", aws_sdk_tcl_dynamodb_QueryCursorCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::scan", aws_sdk_tcl_dynamodb_ScanCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::dynamodb::create_table", aws_sdk_tcl_dynamodb_CreateTableCmd, nullptr,
                          nullptr);
@@ -40,6 +40,7 @@ typedef int Tcl_Size;
                  }
 
 #define CMD_NAME(s, internal) std::sprintf((s), "_AWS_IAM_%p", (internal))
+#define SHARED_CMD_NAME(s, internal, id) std::sprintf((s), "_AWS_IAM_%p_%lu", (internal), (id))
 
 static char VAR_READ_ONLY_MSG[] = "var is read-only";
 
@@ -63,7 +64,7 @@ static char client_usage[] =
         ;
 
 
-static int
+static ClientData
 aws_sdk_tcl_iam_RegisterName(const char *name, Aws::IAM::IAMClient *internal) {
 
     Tcl_HashEntry *entryPtr;
@@ -72,14 +73,16 @@ aws_sdk_tcl_iam_RegisterName(const char *name, Aws::IAM::IAMClient *internal) {
     Tcl_MutexLock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
     entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_iam_NameToInternal_HT, (char *) name, &newEntry);
     if (newEntry) {
-        Tcl_SetHashValue(entryPtr, (ClientData) internal);
+        Tcl_SetHashValue(entryPtr, (ClientData) aws_sdk_tcl_AllocSlot(&aws_sdk_tcl_iam_NameToInternal_HT, internal));
     }
+    // becomes the clientData of the handle command
+    ClientData handleRef = aws_sdk_tcl_NewHandleRef((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr), name);
     Tcl_MutexUnlock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
 
     DBG(fprintf(stderr, "--> RegisterName: name=%s internal=%p %s\n", name, internal,
                 newEntry ? "entered into" : "already in"));
 
-    return !!newEntry;
+    return handleRef;
 }
 
 static int
@@ -90,6 +93,7 @@ aws_sdk_tcl_iam_UnregisterName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_iam_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
+        aws_sdk_tcl_FreeSlot((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
         Tcl_DeleteHashEntry(entryPtr);
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
@@ -107,27 +111,57 @@ aws_sdk_tcl_iam_GetInternalFromName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_iam_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
-        internal = (Aws::IAM::IAMClient *) Tcl_GetHashValue(entryPtr);
+        internal = (Aws::IAM::IAMClient *) aws_sdk_tcl_GetSlotItem((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
 
     return internal;
 }
 
+static Aws::IAM::IAMClient *
+aws_sdk_tcl_iam_GetInternalFromObj(Tcl_Obj *objPtr) {
+    // no locking once the object caches the slot of the handle
+    auto *internal = (Aws::IAM::IAMClient *) aws_sdk_tcl_GetCachedItem(objPtr, &aws_sdk_tcl_iam_NameToInternal_HT);
+    if (internal == nullptr) {
+        Tcl_HashEntry *entryPtr;
+
+        Tcl_MutexLock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
+        entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_iam_NameToInternal_HT, Tcl_GetString(objPtr));
+        if (entryPtr != nullptr) {
+            internal = (Aws::IAM::IAMClient *) aws_sdk_tcl_SetCachedItem(objPtr, (aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
+        }
+        Tcl_MutexUnlock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
+    }
+
+    return internal;
+}
+
+static void
+aws_sdk_tcl_iam_DeleteClient(void *client) {
+    delete (Aws::IAM::IAMClient *) client;
+}
+
 int aws_sdk_tcl_iam_Destroy(Tcl_Interp *interp, const char *handle) {
     Aws::IAM::IAMClient *client = aws_sdk_tcl_iam_GetInternalFromName(handle);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
     if (!aws_sdk_tcl_iam_UnregisterName(handle)) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
-    delete client;
+    // a shared client is only destroyed with its last handle
+    if (aws_sdk_tcl_ReleaseSharedClient(client)) {
+        aws_sdk_tcl_iam_DeleteClient(client);
+    }
     Tcl_DeleteCommand(interp, handle);
     Tcl_SetObjResult(interp, Tcl_NewStringObj(handle, -1));
     return TCL_OK;
 }
 
-int aws_sdk_tcl_iam_CreateRole(Tcl_Interp *interp, const char *handle, const char *role_name, const char *policy) {
-    Aws::IAM::IAMClient *client = aws_sdk_tcl_iam_GetInternalFromName(handle);
+int aws_sdk_tcl_iam_CreateRole(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *role_name, const char *policy) {
+    Aws::IAM::IAMClient *client = aws_sdk_tcl_iam_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -139,7 +173,7 @@ int aws_sdk_tcl_iam_CreateRole(Tcl_Interp *interp, const char *handle, const cha
 
     Aws::IAM::Model::CreateRoleOutcome outcome = client->CreateRole(request);
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "IAM", outcome.GetError());
         return TCL_ERROR;
     }
     else {
@@ -153,8 +187,8 @@ int aws_sdk_tcl_iam_CreateRole(Tcl_Interp *interp, const char *handle, const cha
     }
 }
 
-int aws_sdk_tcl_iam_DeleteRole(Tcl_Interp *interp, const char *handle, const char *role_name) {
-    Aws::IAM::IAMClient *client = aws_sdk_tcl_iam_GetInternalFromName(handle);
+int aws_sdk_tcl_iam_DeleteRole(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *role_name) {
+    Aws::IAM::IAMClient *client = aws_sdk_tcl_iam_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -165,15 +199,15 @@ int aws_sdk_tcl_iam_DeleteRole(Tcl_Interp *interp, const char *handle, const cha
 
     Aws::IAM::Model::DeleteRoleOutcome outcome = client->DeleteRole(request);
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "IAM", outcome.GetError());
         return TCL_ERROR;
     } else {
         return TCL_OK;
     }
 }
 
-int aws_sdk_tcl_iam_ListPolicies(Tcl_Interp *interp, const char *handle) {
-    Aws::IAM::IAMClient *client = aws_sdk_tcl_iam_GetInternalFromName(handle);
+int aws_sdk_tcl_iam_ListPolicies(Tcl_Interp *interp, Tcl_Obj *handlePtr) {
+    Aws::IAM::IAMClient *client = aws_sdk_tcl_iam_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -185,7 +219,7 @@ int aws_sdk_tcl_iam_ListPolicies(Tcl_Interp *interp, const char *handle) {
     while (!done) {
         auto outcome = client->ListPolicies(request);
         if (!outcome.IsSuccess()) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+            aws_sdk_tcl_SetErrorResult(interp, "IAM", outcome.GetError());
             return TCL_ERROR;
         }
         const Aws::String DATE_FORMAT("%Y-%m-%d");
@@ -244,18 +278,20 @@ int aws_sdk_tcl_iam_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
     if (TCL_OK == Tcl_GetIndexFromObj(interp, objv[1], clientMethods, "method", 0, &methodIndex)) {
         Tcl_ResetResult(interp);
         const char *handle = Tcl_GetString(objv[0]);
+        aws_sdk_tcl_HandleObj handleObj(clientData);
+        Tcl_Obj *handlePtr = handleObj.objPtr;
         switch ((enum clientMethod) methodIndex) {
             case m_destroy:
                 return aws_sdk_tcl_iam_Destroy(interp, handle);
             case m_createRole:
                 CheckArgs(4, 4, 1, "create_role role_name policy");
-                return aws_sdk_tcl_iam_CreateRole(interp, handle, Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
+                return aws_sdk_tcl_iam_CreateRole(interp, handlePtr, Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
             case m_deleteRole:
                 CheckArgs(3, 3, 1, "create_role role_name");
-                return aws_sdk_tcl_iam_DeleteRole(interp, handle, Tcl_GetString(objv[2]));
+                return aws_sdk_tcl_iam_DeleteRole(interp, handlePtr, Tcl_GetString(objv[2]));
             case m_listPolicies:
                 CheckArgs(2, 2, 1, "list_policies");
-                return aws_sdk_tcl_iam_ListPolicies(interp, handle);
+                return aws_sdk_tcl_iam_ListPolicies(interp, handlePtr);
         }
     }
 
@@ -295,36 +331,55 @@ char *aws_sdk_tcl_iam_VarTraceProc(ClientData clientData, Tcl_Interp *interp, co
 static int aws_sdk_tcl_iam_CreateCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "CreateCmd\n"));
 
-    CheckArgs(2, 3, 1, "config_dict ?varname?");
+    int shared = objc > 1 && 0 == strcmp(Tcl_GetString(objv[1]), "-shared");
+    CheckArgs(2 + shared, 3 + shared, 1, "?-shared? config_dict ?varname?");
 
-    auto result = get_client_config_and_credentials_provider(interp, objv[1]);
-    int status = std::get<0>(result);
-    if (TCL_OK != status) {
-        SetResult("Invalid config_dict");
-        return TCL_ERROR;
+    Aws::String key;
+    Aws::IAM::IAMClient *client = nullptr;
+    if (shared) {
+        if (TCL_OK != aws_sdk_tcl_GetSharedClientKey(interp, "iam", objv[1 + shared], key)) {
+            return TCL_ERROR;
+        }
+        // the configuration and credentials are only set up for a new client
+        client = (Aws::IAM::IAMClient *) aws_sdk_tcl_FindSharedClient(key);
     }
-    Aws::Client::ClientConfiguration client_config = std::get<1>(result);
-    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+    if (!client) {
+        auto result = get_client_config_and_credentials_provider(interp, objv[1 + shared]);
+        int status = std::get<0>(result);
+        if (TCL_OK != status) {
+            return TCL_ERROR;
+        }
+        Aws::Client::ClientConfiguration client_config = std::get<1>(result);
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
 
-    auto *client = credentials_provider_ptr != nullptr ? new Aws::IAM::IAMClient(credentials_provider_ptr, client_config) : new Aws::IAM::IAMClient(client_config);
+        client = credentials_provider_ptr != nullptr ? new Aws::IAM::IAMClient(credentials_provider_ptr, client_config)
+                                                     : new Aws::IAM::IAMClient(client_config);
+        if (shared) {
+            client = (Aws::IAM::IAMClient *) aws_sdk_tcl_AddSharedClient(key, client, aws_sdk_tcl_iam_DeleteClient);
+        }
+    }
     char handle[80];
-    CMD_NAME(handle, client);
-    aws_sdk_tcl_iam_RegisterName(handle, client);
+    if (shared) {
+        SHARED_CMD_NAME(handle, client, aws_sdk_tcl_NewSharedHandleId());
+    } else {
+        CMD_NAME(handle, client);
+    }
+    ClientData handleRef = aws_sdk_tcl_iam_RegisterName(handle, client);
 
     Tcl_CreateObjCommand(interp, handle,
                          (Tcl_ObjCmdProc *) aws_sdk_tcl_iam_ClientObjCmd,
-                         nullptr,
-                         nullptr);
+                         handleRef,
+                         (Tcl_CmdDeleteProc *) aws_sdk_tcl_FreeHandleRef);
 //                                 (Tcl_CmdDeleteProc*) aws_sdk_tcl_iam_clientObjCmdDeleteProc);
 
 
-    if (objc == 3) {
+    if (objc == 3 + shared) {
         auto *trace = (aws_sdk_tcl_iam_trace_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_iam_trace_t));
         trace->interp = interp;
-        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2]), 80);
+        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2 + shared]), 80);
         trace->handle = aws_sdk_strndup(handle, 80);
         trace->item = client;
-        const char *objVar = Tcl_GetString(objv[2]);
+        const char *objVar = Tcl_GetString(objv[2 + shared]);
         Tcl_UnsetVar(interp, objVar, 0);
         Tcl_SetVar  (interp, objVar, handle, 0);
         Tcl_TraceVar(interp,objVar,TCL_TRACE_WRITES|TCL_TRACE_UNSETS,
@@ -346,27 +401,26 @@ static int aws_sdk_tcl_iam_DestroyCmd(ClientData clientData, Tcl_Interp *interp,
 static int aws_sdk_tcl_iam_CreateRoleCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "CreateRoleCmd\n"));
     CheckArgs(4, 4, 1, "handle role_name policy");
-    return aws_sdk_tcl_iam_CreateRole(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
+    return aws_sdk_tcl_iam_CreateRole(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
 }
 
 static int aws_sdk_tcl_iam_DeleteRoleCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "DeleteRoleCmd\n"));
     CheckArgs(3, 3, 1, "handle role_name");
-    return aws_sdk_tcl_iam_DeleteRole(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_iam_DeleteRole(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_iam_ListPoliciesCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "ListPoliciesCmd\n"));
     CheckArgs(2, 2, 1, "handle");
-    return aws_sdk_tcl_iam_ListPolicies(interp, Tcl_GetString(objv[1]));
+    return aws_sdk_tcl_iam_ListPolicies(interp, objv[1]);
 }
 
-static Aws::SDKOptions options;
-
 static void aws_sdk_tcl_iam_ExitHandler(ClientData unused) {
     Tcl_MutexLock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
     Tcl_DeleteHashTable(&aws_sdk_tcl_iam_NameToInternal_HT);
-    Aws::ShutdownAPI(options);
+    aws_sdk_tcl_ShutdownAPI();
+    aws_sdk_tcl_iam_ModuleInitialized = 0;
     Tcl_MutexUnlock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
 
 }
@@ -375,7 +429,7 @@ static void aws_sdk_tcl_iam_ExitHandler(ClientData unused) {
 void aws_sdk_tcl_iam_InitModule() {
     Tcl_MutexLock(&aws_sdk_tcl_iam_NameToInternal_HT_Mutex);
     if (!aws_sdk_tcl_iam_ModuleInitialized) {
-        Aws::InitAPI(options);
+        aws_sdk_tcl_InitAPI();
         Tcl_InitHashTable(&aws_sdk_tcl_iam_NameToInternal_HT, TCL_STRING_KEYS);
         Tcl_CreateThreadExitHandler(aws_sdk_tcl_iam_ExitHandler, nullptr);
         aws_sdk_tcl_iam_ModuleInitialized = 1;
@@ -399,6 +453,7 @@ int Aws_sdk_tcl_iam_Init(Tcl_Interp *interp) {
     aws_sdk_tcl_iam_InitModule();
 
     Tcl_CreateNamespace(interp, "::aws::iam", nullptr, nullptr);
+    aws_sdk_tcl_CreateCommonCmds(interp);
     Tcl_CreateObjCommand(interp, "::aws::iam::create", aws_sdk_tcl_iam_CreateCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::iam::destroy", aws_sdk_tcl_iam_DestroyCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::iam::create_role", aws_sdk_tcl_iam_CreateRoleCmd, nullptr, nullptr);
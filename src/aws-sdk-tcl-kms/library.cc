@@ -48,6 +48,7 @@ typedef int Tcl_Size;
                  }
 
 #define CMD_NAME(s,internal) std::sprintf((s), "_AWS_KMS_%p", (internal))
+#define SHARED_CMD_NAME(s, internal, id) std::sprintf((s), "_AWS_KMS_%p_%lu", (internal), (id))
 
 static char VAR_READ_ONLY_MSG[] = "var is read-only";
 
@@ -78,7 +79,7 @@ static char kms_client_usage[] =
     "   destroy                                            \n"
 ;
 
-static int aws_sdk_tcl_kms_RegisterName(const char *name, Aws::KMS::KMSClient *internal) {
+static ClientData aws_sdk_tcl_kms_RegisterName(const char *name, Aws::KMS::KMSClient *internal) {
 
     Tcl_HashEntry *entryPtr;
     int newEntry;
@@ -86,13 +87,15 @@ static int aws_sdk_tcl_kms_RegisterName(const char *name, Aws::KMS::KMSClient *i
     Tcl_MutexLock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
     entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_kms_NameToInternal_HT, (char*) name, &newEntry);
     if (newEntry) {
-        Tcl_SetHashValue(entryPtr, (ClientData)internal);
+        Tcl_SetHashValue(entryPtr, (ClientData) aws_sdk_tcl_AllocSlot(&aws_sdk_tcl_kms_NameToInternal_HT, internal));
     }
+    // becomes the clientData of the handle command
+    ClientData handleRef = aws_sdk_tcl_NewHandleRef((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr), name);
     Tcl_MutexUnlock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
 
     DBG(fprintf(stderr, "--> RegisterName: name=%s internal=%p %s\n", name, internal, newEntry ? "entered into" : "already in"));
 
-    return !!newEntry;
+    return handleRef;
 }
 
 static int aws_sdk_tcl_kms_UnregisterName(const char *name) {
@@ -102,6 +105,7 @@ static int aws_sdk_tcl_kms_UnregisterName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_kms_NameToInternal_HT, (char*)name);
     if (entryPtr != nullptr) {
+        aws_sdk_tcl_FreeSlot((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
         Tcl_DeleteHashEntry(entryPtr);
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
@@ -118,29 +122,58 @@ static struct Aws::KMS::KMSClient *aws_sdk_tcl_kms_GetInternalFromName(const cha
     Tcl_MutexLock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_kms_NameToInternal_HT, (char*)name);
     if (entryPtr != nullptr) {
-        internal = (Aws::KMS::KMSClient *)Tcl_GetHashValue(entryPtr);
+        internal = (Aws::KMS::KMSClient *) aws_sdk_tcl_GetSlotItem((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
 
     return internal;
 }
 
+static Aws::KMS::KMSClient * aws_sdk_tcl_kms_GetInternalFromObj(Tcl_Obj *objPtr) {
+    // no locking once the object caches the slot of the handle
+    auto *internal = (Aws::KMS::KMSClient *) aws_sdk_tcl_GetCachedItem(objPtr, &aws_sdk_tcl_kms_NameToInternal_HT);
+    if (internal == nullptr) {
+        Tcl_HashEntry *entryPtr;
+
+        Tcl_MutexLock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
+        entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_kms_NameToInternal_HT, Tcl_GetString(objPtr));
+        if (entryPtr != nullptr) {
+            internal = (Aws::KMS::KMSClient *) aws_sdk_tcl_SetCachedItem(objPtr, (aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
+        }
+        Tcl_MutexUnlock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
+    }
+
+    return internal;
+}
+
+static void
+aws_sdk_tcl_kms_DeleteClient(void *client) {
+    Aws::KMS::KMSClient::ShutdownSdkClient(client, -1);
+    delete (Aws::KMS::KMSClient *) client;
+}
+
 int aws_sdk_tcl_kms_Destroy(Tcl_Interp *interp, const char *handle) {
     Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
     if (!aws_sdk_tcl_kms_UnregisterName(handle)) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
-    Aws::KMS::KMSClient::ShutdownSdkClient(client, -1);
-    delete client;
+    // a shared client is only destroyed with its last handle
+    if (aws_sdk_tcl_ReleaseSharedClient(client)) {
+        aws_sdk_tcl_kms_DeleteClient(client);
+    }
     Tcl_DeleteCommand(interp, handle);
     Tcl_SetObjResult(interp, Tcl_NewStringObj(handle, -1));
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_ListKeys(Tcl_Interp *interp, const char *handle) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_ListKeys: handle=%s\n", handle));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_ListKeys(Tcl_Interp *interp, Tcl_Obj *handlePtr) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_ListKeys: handle=%s\n", Tcl_GetString(handlePtr)));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -156,7 +189,7 @@ int aws_sdk_tcl_kms_ListKeys(Tcl_Interp *interp, const char *handle) {
         Aws::KMS::Model::ListKeysOutcome outcome = client->ListKeys(request);
 
         if (!outcome.IsSuccess()) {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+            aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
             Tcl_BounceRefCount(rc);
             return TCL_ERROR;
         }
@@ -177,9 +210,9 @@ int aws_sdk_tcl_kms_ListKeys(Tcl_Interp *interp, const char *handle) {
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_CreateKey(Tcl_Interp *interp, const char *handle) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_CreateKey: handle=%s\n", handle));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_CreateKey(Tcl_Interp *interp, Tcl_Obj *handlePtr) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_CreateKey: handle=%s\n", Tcl_GetString(handlePtr)));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -190,7 +223,7 @@ int aws_sdk_tcl_kms_CreateKey(Tcl_Interp *interp, const char *handle) {
     Aws::KMS::Model::CreateKeyOutcome outcome = client->CreateKey(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -246,9 +279,9 @@ Tcl_Obj *aws_sdk_tcl_json2dict(const Aws::Utils::Json::JsonView json) {
 
 }
 
-int aws_sdk_tcl_kms_DescribeKey(Tcl_Interp *interp, const char *handle, const char *arn) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_DescribeKey: handle=%s arn=%s\n", handle, arn));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_DescribeKey(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *arn) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_DescribeKey: handle=%s arn=%s\n", Tcl_GetString(handlePtr), arn));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -260,7 +293,7 @@ int aws_sdk_tcl_kms_DescribeKey(Tcl_Interp *interp, const char *handle, const ch
     Aws::KMS::Model::DescribeKeyOutcome outcome = client->DescribeKey(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -270,9 +303,9 @@ int aws_sdk_tcl_kms_DescribeKey(Tcl_Interp *interp, const char *handle, const ch
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_EnableKey(Tcl_Interp *interp, const char *handle, const char *arn) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_EnableKey: handle=%s arn=%s\n", handle, arn));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_EnableKey(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *arn) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_EnableKey: handle=%s arn=%s\n", Tcl_GetString(handlePtr), arn));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -284,7 +317,7 @@ int aws_sdk_tcl_kms_EnableKey(Tcl_Interp *interp, const char *handle, const char
     Aws::KMS::Model::EnableKeyOutcome outcome = client->EnableKey(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -292,9 +325,9 @@ int aws_sdk_tcl_kms_EnableKey(Tcl_Interp *interp, const char *handle, const char
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_DisableKey(Tcl_Interp *interp, const char *handle, const char *arn) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_DisableKey: handle=%s arn=%s\n", handle, arn));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_DisableKey(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *arn) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_DisableKey: handle=%s arn=%s\n", Tcl_GetString(handlePtr), arn));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -306,7 +339,7 @@ int aws_sdk_tcl_kms_DisableKey(Tcl_Interp *interp, const char *handle, const cha
     Aws::KMS::Model::DisableKeyOutcome outcome = client->DisableKey(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -314,9 +347,9 @@ int aws_sdk_tcl_kms_DisableKey(Tcl_Interp *interp, const char *handle, const cha
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_ScheduleKeyDeletion(Tcl_Interp *interp, const char *handle, const char *arn, int pending_window) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_ScheduleKeyDeletion: handle=%s arn=%s pending_window=%d\n", handle, arn, pending_window));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_ScheduleKeyDeletion(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *arn, int pending_window) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_ScheduleKeyDeletion: handle=%s arn=%s pending_window=%d\n", Tcl_GetString(handlePtr), arn, pending_window));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -331,7 +364,7 @@ int aws_sdk_tcl_kms_ScheduleKeyDeletion(Tcl_Interp *interp, const char *handle,
     Aws::KMS::Model::ScheduleKeyDeletionOutcome outcome = client->ScheduleKeyDeletion(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -339,9 +372,9 @@ int aws_sdk_tcl_kms_ScheduleKeyDeletion(Tcl_Interp *interp, const char *handle,
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_CancelKeyDeletion(Tcl_Interp *interp, const char *handle, const char *arn) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_CancelKeyDeletion: handle=%s arn=%s\n", handle, arn));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_CancelKeyDeletion(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *arn) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_CancelKeyDeletion: handle=%s arn=%s\n", Tcl_GetString(handlePtr), arn));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -353,7 +386,7 @@ int aws_sdk_tcl_kms_CancelKeyDeletion(Tcl_Interp *interp, const char *handle, co
     Aws::KMS::Model::CancelKeyDeletionOutcome outcome = client->CancelKeyDeletion(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -361,9 +394,9 @@ int aws_sdk_tcl_kms_CancelKeyDeletion(Tcl_Interp *interp, const char *handle, co
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_Encrypt(Tcl_Interp *interp, const char *handle, const char *arn, const unsigned char *buffer, Tcl_Size size) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_Encrypt: handle=%s arn=%s buffer=%p size=%" TCL_SIZE_MODIFIER "d\n", handle, arn, (void *)buffer, size));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_Encrypt(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *arn, const unsigned char *buffer, Tcl_Size size) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_Encrypt: handle=%s arn=%s buffer=%p size=%" TCL_SIZE_MODIFIER "d\n", Tcl_GetString(handlePtr), arn, (void *)buffer, size));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -378,7 +411,7 @@ int aws_sdk_tcl_kms_Encrypt(Tcl_Interp *interp, const char *handle, const char *
     Aws::KMS::Model::EncryptOutcome outcome = client->Encrypt(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -388,9 +421,9 @@ int aws_sdk_tcl_kms_Encrypt(Tcl_Interp *interp, const char *handle, const char *
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_Decrypt(Tcl_Interp *interp, const char *handle, const unsigned char *buffer, Tcl_Size size) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_Encrypt: handle=%s buffer=%p size=%" TCL_SIZE_MODIFIER "d\n", handle, (void *)buffer, size));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_Decrypt(Tcl_Interp *interp, Tcl_Obj *handlePtr, const unsigned char *buffer, Tcl_Size size) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_Encrypt: handle=%s buffer=%p size=%" TCL_SIZE_MODIFIER "d\n", Tcl_GetString(handlePtr), (void *)buffer, size));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -404,7 +437,7 @@ int aws_sdk_tcl_kms_Decrypt(Tcl_Interp *interp, const char *handle, const unsign
     Aws::KMS::Model::DecryptOutcome outcome = client->Decrypt(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -414,9 +447,9 @@ int aws_sdk_tcl_kms_Decrypt(Tcl_Interp *interp, const char *handle, const unsign
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_GenerateDataKey(Tcl_Interp *interp, const char *handle, const char *arn, int num_bytes) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_GenerateDataKey: handle=%s arn=%s num_bytes=%d\n", handle, arn, num_bytes));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_GenerateDataKey(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *arn, int num_bytes) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_GenerateDataKey: handle=%s arn=%s num_bytes=%d\n", Tcl_GetString(handlePtr), arn, num_bytes));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -429,7 +462,7 @@ int aws_sdk_tcl_kms_GenerateDataKey(Tcl_Interp *interp, const char *handle, cons
     Aws::KMS::Model::GenerateDataKeyOutcome outcome = client->GenerateDataKey(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -445,9 +478,9 @@ int aws_sdk_tcl_kms_GenerateDataKey(Tcl_Interp *interp, const char *handle, cons
     return TCL_OK;
 }
 
-int aws_sdk_tcl_kms_GenerateRandom(Tcl_Interp *interp, const char *handle, int num_bytes) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_kms_GenerateRandom: handle=%s num_bytes=%d\n", handle, num_bytes));
-    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromName(handle);
+int aws_sdk_tcl_kms_GenerateRandom(Tcl_Interp *interp, Tcl_Obj *handlePtr, int num_bytes) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_kms_GenerateRandom: handle=%s num_bytes=%d\n", Tcl_GetString(handlePtr), num_bytes));
+    Aws::KMS::KMSClient *client = aws_sdk_tcl_kms_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -459,7 +492,7 @@ int aws_sdk_tcl_kms_GenerateRandom(Tcl_Interp *interp, const char *handle, int n
     Aws::KMS::Model::GenerateRandomOutcome outcome = client->GenerateRandom(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "KMS", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -544,6 +577,10 @@ int aws_sdk_tcl_kms_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
     }
 
     const char *handle = Tcl_GetString(objv[0]);
+
+    aws_sdk_tcl_HandleObj handleObj(clientData);
+    Tcl_Obj *handlePtr = handleObj.objPtr;
+
     switch ((enum clientMethod) methodIndex ) {
         case m_destroy:
             DBG(fprintf(stderr, "DestroyMethod\n"));
@@ -552,23 +589,23 @@ int aws_sdk_tcl_kms_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
         case m_listKeys:
             DBG(fprintf(stderr, "ListKeysMethod\n"));
             CheckArgs(2,2,1,"list_keys");
-            return aws_sdk_tcl_kms_ListKeys(interp, handle);
+            return aws_sdk_tcl_kms_ListKeys(interp, handlePtr);
         case m_createKey:
             DBG(fprintf(stderr, "CreateKeyMethod\n"));
             CheckArgs(2,2,1,"create_key");
-            return aws_sdk_tcl_kms_CreateKey(interp, handle);
+            return aws_sdk_tcl_kms_CreateKey(interp, handlePtr);
         case m_describeKey:
             DBG(fprintf(stderr, "DescribeKeyMethod\n"));
             CheckArgs(3,3,1,"describe_key arn");
-            return aws_sdk_tcl_kms_DescribeKey(interp, handle, Tcl_GetString(objv[2]));
+            return aws_sdk_tcl_kms_DescribeKey(interp, handlePtr, Tcl_GetString(objv[2]));
         case m_enableKey:
             DBG(fprintf(stderr, "EnableKeyMethod\n"));
             CheckArgs(3,3,1,"enable_key arn");
-            return aws_sdk_tcl_kms_EnableKey(interp, handle, Tcl_GetString(objv[2]));
+            return aws_sdk_tcl_kms_EnableKey(interp, handlePtr, Tcl_GetString(objv[2]));
         case m_disableKey:
             DBG(fprintf(stderr, "DisableKeyMethod\n"));
             CheckArgs(3,3,1,"disable_key arn");
-            return aws_sdk_tcl_kms_DisableKey(interp, handle, Tcl_GetString(objv[2]));
+            return aws_sdk_tcl_kms_DisableKey(interp, handlePtr, Tcl_GetString(objv[2]));
         case m_scheduleKeyDeletion: {
             DBG(fprintf(stderr, "ScheduleKeyDeletionMethod\n"));
             CheckArgs(3,4,1,"schedule_key_deletion arn ?pending_window_in_days?");
@@ -576,25 +613,25 @@ int aws_sdk_tcl_kms_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
             if (objc > 3 && Tcl_GetIntFromObj(interp, objv[3], &pending_window) != TCL_OK) {
                 return TCL_ERROR;
             }
-            return aws_sdk_tcl_kms_ScheduleKeyDeletion(interp, handle, Tcl_GetString(objv[2]), pending_window);
+            return aws_sdk_tcl_kms_ScheduleKeyDeletion(interp, handlePtr, Tcl_GetString(objv[2]), pending_window);
         }
         case m_cancelKeyDeletion:
             DBG(fprintf(stderr, "CancelKeyDeletionMethod\n"));
             CheckArgs(3,3,1,"cancel_key_deletion arn");
-            return aws_sdk_tcl_kms_CancelKeyDeletion(interp, handle, Tcl_GetString(objv[2]));
+            return aws_sdk_tcl_kms_CancelKeyDeletion(interp, handlePtr, Tcl_GetString(objv[2]));
         case m_encrypt: {
             DBG(fprintf(stderr, "EncryptMethod\n"));
             CheckArgs(4,4,1,"encrypt arn plain_data");
             Tcl_Size size;
             const unsigned char *buffer = Tcl_GetByteArrayFromObj(objv[3], &size);
-            return aws_sdk_tcl_kms_Encrypt(interp, handle, Tcl_GetString(objv[2]), buffer, size);
+            return aws_sdk_tcl_kms_Encrypt(interp, handlePtr, Tcl_GetString(objv[2]), buffer, size);
         }
         case m_decrypt: {
             DBG(fprintf(stderr, "DecryptMethod\n"));
             CheckArgs(3,3,1,"decrypt cipher_data");
             Tcl_Size size;
             const unsigned char *buffer = Tcl_GetByteArrayFromObj(objv[2], &size);
-            return aws_sdk_tcl_kms_Decrypt(interp, handle, buffer, size);
+            return aws_sdk_tcl_kms_Decrypt(interp, handlePtr, buffer, size);
         }
         case m_generateDataKey: {
             DBG(fprintf(stderr, "GenerateDataKeyMethod\n"));
@@ -603,7 +640,7 @@ int aws_sdk_tcl_kms_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
             if (Tcl_GetIntFromObj(interp, objv[3], &num_bytes) != TCL_OK) {
                 return TCL_ERROR;
             }
-            return aws_sdk_tcl_kms_GenerateDataKey(interp, handle, Tcl_GetString(objv[2]), num_bytes);
+            return aws_sdk_tcl_kms_GenerateDataKey(interp, handlePtr, Tcl_GetString(objv[2]), num_bytes);
         }
         case m_generateRandom: {
             DBG(fprintf(stderr, "GenerateRandomMethod\n"));
@@ -612,7 +649,7 @@ int aws_sdk_tcl_kms_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
             if (Tcl_GetIntFromObj(interp, objv[2], &num_bytes) != TCL_OK) {
                 return TCL_ERROR;
             }
-            return aws_sdk_tcl_kms_GenerateRandom(interp, handle, num_bytes);
+            return aws_sdk_tcl_kms_GenerateRandom(interp, handlePtr, num_bytes);
         }
     }
 
@@ -623,39 +660,56 @@ int aws_sdk_tcl_kms_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
 static int aws_sdk_tcl_kms_CreateCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[]) {
     DBG(fprintf(stderr, "CreateCmd\n"));
 
-    CheckArgs(2,3,1,"config_dict ?varname?");
+    int shared = objc > 1 && 0 == strcmp(Tcl_GetString(objv[1]), "-shared");
+    CheckArgs(2 + shared,3 + shared,1,"?-shared? config_dict ?varname?");
 
-    auto result = get_client_config_and_credentials_provider(interp, objv[1]);
-    int status = std::get<0>(result);
-    if (TCL_OK != status) {
-        SetResult("Invalid config_dict");
-        return TCL_ERROR;
+    Aws::String key;
+    Aws::KMS::KMSClient *client = nullptr;
+    if (shared) {
+        if (TCL_OK != aws_sdk_tcl_GetSharedClientKey(interp, "kms", objv[1 + shared], key)) {
+            return TCL_ERROR;
+        }
+        // the configuration and credentials are only set up for a new client
+        client = (Aws::KMS::KMSClient *) aws_sdk_tcl_FindSharedClient(key);
+    }
+    if (!client) {
+        auto result = get_client_config_and_credentials_provider(interp, objv[1 + shared]);
+        int status = std::get<0>(result);
+        if (TCL_OK != status) {
+            return TCL_ERROR;
+        }
+        Aws::Client::ClientConfiguration client_config = std::get<1>(result);
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+
+        client = credentials_provider_ptr != nullptr ?
+            new Aws::KMS::KMSClient(credentials_provider_ptr,
+                Aws::MakeShared<Aws::KMS::KMSEndpointProvider>(Aws::KMS::KMSClient::ALLOCATION_TAG),
+                client_config) :
+            new Aws::KMS::KMSClient(client_config);
+        if (shared) {
+            client = (Aws::KMS::KMSClient *) aws_sdk_tcl_AddSharedClient(key, client, aws_sdk_tcl_kms_DeleteClient);
+        }
     }
-    Aws::Client::ClientConfiguration client_config = std::get<1>(result);
-    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
-
-    auto *client = credentials_provider_ptr != nullptr ?
-        new Aws::KMS::KMSClient(credentials_provider_ptr,
-            Aws::MakeShared<Aws::KMS::KMSEndpointProvider>(Aws::KMS::KMSClient::ALLOCATION_TAG),
-            client_config) :
-        new Aws::KMS::KMSClient(client_config);
-
     char handle[80];
-    CMD_NAME(handle, client);
-    aws_sdk_tcl_kms_RegisterName(handle, client);
+    if (shared) {
+        SHARED_CMD_NAME(handle, client, aws_sdk_tcl_NewSharedHandleId());
+    } else {
+        CMD_NAME(handle, client);
+    }
+    ClientData handleRef = aws_sdk_tcl_kms_RegisterName(handle, client);
 
     Tcl_CreateObjCommand(interp, handle,
                                  (Tcl_ObjCmdProc *)  aws_sdk_tcl_kms_ClientObjCmd,
-                                 nullptr,
-                                 nullptr);
+                                 handleRef,
+                                 (Tcl_CmdDeleteProc *) aws_sdk_tcl_FreeHandleRef);
 
-    if (objc == 3) {
+    if (objc == 3 + shared) {
         auto *trace = (aws_sdk_tcl_kms_trace_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_kms_trace_t));
         trace->interp = interp;
-        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2]), 80);
+        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2 + shared]), 80);
         trace->handle = aws_sdk_strndup(handle, 80);
         trace->item = client;
-        const char *objVar = Tcl_GetString(objv[2]);
+        const char *objVar = Tcl_GetString(objv[2 + shared]);
         Tcl_UnsetVar(interp, objVar, 0);
         Tcl_SetVar  (interp, objVar, handle, 0);
         Tcl_TraceVar(interp,objVar,TCL_TRACE_WRITES|TCL_TRACE_UNSETS,
@@ -676,31 +730,31 @@ static int aws_sdk_tcl_kms_DestroyCmd(ClientData  clientData, Tcl_Interp *interp
 static int aws_sdk_tcl_kms_ListKeysCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "ListKeysCmd\n"));
     CheckArgs(2,2,1,"handle");
-    return aws_sdk_tcl_kms_ListKeys(interp, Tcl_GetString(objv[1]));
+    return aws_sdk_tcl_kms_ListKeys(interp, objv[1]);
 }
 
 static int aws_sdk_tcl_kms_CreateKeyCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "CreateKeyCmd\n"));
     CheckArgs(2,2,1,"handle");
-    return aws_sdk_tcl_kms_ListKeys(interp, Tcl_GetString(objv[1]));
+    return aws_sdk_tcl_kms_ListKeys(interp, objv[1]);
 }
 
 static int aws_sdk_tcl_kms_DescribeKeyCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "DescribeKeyCmd\n"));
     CheckArgs(3,3,1,"handle arn");
-    return aws_sdk_tcl_kms_DescribeKey(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_kms_DescribeKey(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_kms_EnableKeyCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "EnableKeyCmd\n"));
     CheckArgs(3,3,1,"handle arn");
-    return aws_sdk_tcl_kms_EnableKey(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_kms_EnableKey(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_kms_DisableKeyCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "DisableKeyCmd\n"));
     CheckArgs(3,3,1,"handle arn");
-    return aws_sdk_tcl_kms_DisableKey(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_kms_DisableKey(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_kms_ScheduleKeyDeletionCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
@@ -710,13 +764,13 @@ static int aws_sdk_tcl_kms_ScheduleKeyDeletionCmd(ClientData  clientData, Tcl_In
     if (objc > 3 && Tcl_GetIntFromObj(interp, objv[3], &pending_window) != TCL_OK) {
         return TCL_ERROR;
     }
-    return aws_sdk_tcl_kms_ScheduleKeyDeletion(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), pending_window);
+    return aws_sdk_tcl_kms_ScheduleKeyDeletion(interp, objv[1], Tcl_GetString(objv[2]), pending_window);
 }
 
 static int aws_sdk_tcl_kms_CancelKeyDeletionCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "CancelKeyDeletionCmd\n"));
     CheckArgs(3,3,1,"handle arn");
-    return aws_sdk_tcl_kms_CancelKeyDeletion(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_kms_CancelKeyDeletion(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_kms_EncryptCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
@@ -724,7 +778,7 @@ static int aws_sdk_tcl_kms_EncryptCmd(ClientData  clientData, Tcl_Interp *interp
     CheckArgs(4,4,1,"handle arn plain_data");
     Tcl_Size size;
     const unsigned char *buffer = Tcl_GetByteArrayFromObj(objv[3], &size);
-    return aws_sdk_tcl_kms_Encrypt(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), buffer, size);
+    return aws_sdk_tcl_kms_Encrypt(interp, objv[1], Tcl_GetString(objv[2]), buffer, size);
 }
 
 static int aws_sdk_tcl_kms_DecryptCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
@@ -732,7 +786,7 @@ static int aws_sdk_tcl_kms_DecryptCmd(ClientData  clientData, Tcl_Interp *interp
     CheckArgs(3,3,1,"handle cipher_data");
     Tcl_Size size;
     const unsigned char *buffer = Tcl_GetByteArrayFromObj(objv[2], &size);
-    return aws_sdk_tcl_kms_Decrypt(interp, Tcl_GetString(objv[1]), buffer, size);
+    return aws_sdk_tcl_kms_Decrypt(interp, objv[1], buffer, size);
 }
 
 static int aws_sdk_tcl_kms_GenerateDataKeyCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
@@ -742,7 +796,7 @@ static int aws_sdk_tcl_kms_GenerateDataKeyCmd(ClientData  clientData, Tcl_Interp
     if (Tcl_GetIntFromObj(interp, objv[3], &num_bytes) != TCL_OK) {
         return TCL_ERROR;
     }
-    return aws_sdk_tcl_kms_GenerateDataKey(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), num_bytes);
+    return aws_sdk_tcl_kms_GenerateDataKey(interp, objv[1], Tcl_GetString(objv[2]), num_bytes);
 }
 
 static int aws_sdk_tcl_kms_GenerateRandomCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
@@ -752,23 +806,22 @@ static int aws_sdk_tcl_kms_GenerateRandomCmd(ClientData  clientData, Tcl_Interp
     if (Tcl_GetIntFromObj(interp, objv[2], &num_bytes) != TCL_OK) {
         return TCL_ERROR;
     }
-    return aws_sdk_tcl_kms_GenerateRandom(interp, Tcl_GetString(objv[1]), num_bytes);
+    return aws_sdk_tcl_kms_GenerateRandom(interp, objv[1], num_bytes);
 }
 
-static Aws::SDKOptions options;
-
 static void aws_sdk_tcl_kms_ExitHandler(ClientData unused)
 {
     Tcl_MutexLock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
     Tcl_DeleteHashTable(&aws_sdk_tcl_kms_NameToInternal_HT);
-    Aws::ShutdownAPI(options);
+    aws_sdk_tcl_ShutdownAPI();
+    aws_sdk_tcl_kms_ModuleInitialized = 0;
     Tcl_MutexUnlock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
 }
 
 void aws_sdk_tcl_kms_InitModule() {
     Tcl_MutexLock(&aws_sdk_tcl_kms_NameToInternal_HT_Mutex);
     if (!aws_sdk_tcl_kms_ModuleInitialized) {
-        Aws::InitAPI(options);
+        aws_sdk_tcl_InitAPI();
         Tcl_InitHashTable(&aws_sdk_tcl_kms_NameToInternal_HT, TCL_STRING_KEYS);
         Tcl_CreateThreadExitHandler(aws_sdk_tcl_kms_ExitHandler, nullptr);
         aws_sdk_tcl_kms_ModuleInitialized = 1;
@@ -792,6 +845,7 @@ int Aws_sdk_tcl_kms_Init(Tcl_Interp *interp) {
     aws_sdk_tcl_kms_InitModule();
 
     Tcl_CreateNamespace(interp, "::aws::kms", nullptr, nullptr);
+    aws_sdk_tcl_CreateCommonCmds(interp);
     Tcl_CreateObjCommand(interp, "::aws::kms::create", aws_sdk_tcl_kms_CreateCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::kms::destroy", aws_sdk_tcl_kms_DestroyCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::kms::list_keys", aws_sdk_tcl_kms_ListKeysCmd, nullptr, nullptr);
@@ -42,6 +42,7 @@ typedef int Tcl_Size;
                  }
 
 #define CMD_NAME(s, internal) std::sprintf((s), "_AWS_LAMBDA_%p", (internal))
+#define SHARED_CMD_NAME(s, internal, id) std::sprintf((s), "_AWS_LAMBDA_%p_%lu", (internal), (id))
 
 static char VAR_READ_ONLY_MSG[] = "var is read-only";
 
@@ -67,7 +68,7 @@ static char lambda_client_usage[] =
         ;
 
 
-static int
+static ClientData
 aws_sdk_tcl_lambda_RegisterName(const char *name, Aws::Lambda::LambdaClient *internal) {
 
     Tcl_HashEntry *entryPtr;
@@ -76,14 +77,16 @@ aws_sdk_tcl_lambda_RegisterName(const char *name, Aws::Lambda::LambdaClient *int
     Tcl_MutexLock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
     entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_lambda_NameToInternal_HT, (char *) name, &newEntry);
     if (newEntry) {
-        Tcl_SetHashValue(entryPtr, (ClientData) internal);
+        Tcl_SetHashValue(entryPtr, (ClientData) aws_sdk_tcl_AllocSlot(&aws_sdk_tcl_lambda_NameToInternal_HT, internal));
     }
+    // becomes the clientData of the handle command
+    ClientData handleRef = aws_sdk_tcl_NewHandleRef((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr), name);
     Tcl_MutexUnlock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
 
     DBG(fprintf(stderr, "--> RegisterName: name=%s internal=%p %s\n", name, internal,
                 newEntry ? "entered into" : "already in"));
 
-    return !!newEntry;
+    return handleRef;
 }
 
 static int
@@ -94,6 +97,7 @@ aws_sdk_tcl_lambda_UnregisterName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_lambda_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
+        aws_sdk_tcl_FreeSlot((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
         Tcl_DeleteHashEntry(entryPtr);
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
@@ -111,20 +115,50 @@ aws_sdk_tcl_lambda_GetInternalFromName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_lambda_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
-        internal = (Aws::Lambda::LambdaClient *) Tcl_GetHashValue(entryPtr);
+        internal = (Aws::Lambda::LambdaClient *) aws_sdk_tcl_GetSlotItem((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
 
     return internal;
 }
 
+static Aws::Lambda::LambdaClient *
+aws_sdk_tcl_lambda_GetInternalFromObj(Tcl_Obj *objPtr) {
+    // no locking once the object caches the slot of the handle
+    auto *internal = (Aws::Lambda::LambdaClient *) aws_sdk_tcl_GetCachedItem(objPtr, &aws_sdk_tcl_lambda_NameToInternal_HT);
+    if (internal == nullptr) {
+        Tcl_HashEntry *entryPtr;
+
+        Tcl_MutexLock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
+        entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_lambda_NameToInternal_HT, Tcl_GetString(objPtr));
+        if (entryPtr != nullptr) {
+            internal = (Aws::Lambda::LambdaClient *) aws_sdk_tcl_SetCachedItem(objPtr, (aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
+        }
+        Tcl_MutexUnlock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
+    }
+
+    return internal;
+}
+
+static void
+aws_sdk_tcl_lambda_DeleteClient(void *client) {
+    delete (Aws::Lambda::LambdaClient *) client;
+}
+
 int aws_sdk_tcl_lambda_Destroy(Tcl_Interp *interp, const char *handle) {
     Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromName(handle);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
     if (!aws_sdk_tcl_lambda_UnregisterName(handle)) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
-    delete client;
+    // a shared client is only destroyed with its last handle
+    if (aws_sdk_tcl_ReleaseSharedClient(client)) {
+        aws_sdk_tcl_lambda_DeleteClient(client);
+    }
     Tcl_DeleteCommand(interp, handle);
     Tcl_SetObjResult(interp, Tcl_NewStringObj(handle, -1));
     return TCL_OK;
@@ -239,9 +273,9 @@ Tcl_Obj *get_dict_from_function_configuration(Tcl_Interp *interp, const Aws::Lam
     return dictPtr;
 }
 
-int aws_sdk_tcl_lambda_ListFunctions(Tcl_Interp *interp, const char *handle) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_ListFunctions: handle=%s\n", handle));
-    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromName(handle);
+int aws_sdk_tcl_lambda_ListFunctions(Tcl_Interp *interp, Tcl_Obj *handlePtr) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_ListFunctions: handle=%s\n", Tcl_GetString(handlePtr)));
+    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -269,7 +303,7 @@ int aws_sdk_tcl_lambda_ListFunctions(Tcl_Interp *interp, const char *handle) {
             marker = result.GetNextMarker();
         }
         else {
-            Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+            aws_sdk_tcl_SetErrorResult(interp, "Lambda", outcome.GetError());
             return TCL_ERROR;
         }
     } while (!marker.empty());
@@ -278,9 +312,9 @@ int aws_sdk_tcl_lambda_ListFunctions(Tcl_Interp *interp, const char *handle) {
     return TCL_OK;
 }
 
-int aws_sdk_tcl_lambda_GetFunction(Tcl_Interp *interp, const char *handle, const char *function_name) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_GetFunction: handle=%s function_name=%s\n", handle, function_name));
-    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromName(handle);
+int aws_sdk_tcl_lambda_GetFunction(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *function_name) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_GetFunction: handle=%s function_name=%s\n", Tcl_GetString(handlePtr), function_name));
+    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -294,14 +328,14 @@ int aws_sdk_tcl_lambda_GetFunction(Tcl_Interp *interp, const char *handle, const
         return TCL_OK;
     }
     else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "Lambda", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 int aws_sdk_tcl_lambda_CreateFunction(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *function_name,
         const char *function_code_path,
         const char *handler,
@@ -309,8 +343,8 @@ int aws_sdk_tcl_lambda_CreateFunction(
         const char *execution_role_arn,
         Tcl_Obj *timeoutPtr
         ) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_CreateFunction: handle=%s function_name=%s\n", handle, function_name));
-    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromName(handle);
+    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_CreateFunction: handle=%s function_name=%s\n", Tcl_GetString(handlePtr), function_name));
+    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -347,18 +381,18 @@ int aws_sdk_tcl_lambda_CreateFunction(
         return TCL_OK;
     }
     else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "Lambda", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 int aws_sdk_tcl_lambda_DeleteFunction(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *function_name
 ) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_DeleteFunction: handle=%s function_name=%s\n", handle, function_name));
-    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromName(handle);
+    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_DeleteFunction: handle=%s function_name=%s\n", Tcl_GetString(handlePtr), function_name));
+    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -372,20 +406,20 @@ int aws_sdk_tcl_lambda_DeleteFunction(
         return TCL_OK;
     }
     else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "Lambda", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 int aws_sdk_tcl_lambda_InvokeFunction(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *function_name,
         const char *payload_json,
         const char *invocation_type
 ) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_DeleteFunction: handle=%s function_name=%s\n", handle, function_name));
-    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromName(handle);
+    DBG(fprintf(stderr, "aws_sdk_tcl_lambda_DeleteFunction: handle=%s function_name=%s\n", Tcl_GetString(handlePtr), function_name));
+    Aws::Lambda::LambdaClient *client = aws_sdk_tcl_lambda_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -410,7 +444,7 @@ int aws_sdk_tcl_lambda_InvokeFunction(
         return TCL_OK;
     }
     else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "Lambda", outcome.GetError());
         return TCL_ERROR;
     }
 }
@@ -446,6 +480,8 @@ int aws_sdk_tcl_lambda_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, i
     if (TCL_OK == Tcl_GetIndexFromObj(interp, objv[1], clientMethods, "method", 0, &methodIndex)) {
         Tcl_ResetResult(interp);
         const char *handle = Tcl_GetString(objv[0]);
+        aws_sdk_tcl_HandleObj handleObj(clientData);
+        Tcl_Obj *handlePtr = handleObj.objPtr;
         switch ((enum clientMethod) methodIndex) {
             case m_destroy:
                 return aws_sdk_tcl_lambda_Destroy(interp, handle);
@@ -453,20 +489,20 @@ int aws_sdk_tcl_lambda_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, i
                 CheckArgs(2, 2, 1, "list_functions");
                 return aws_sdk_tcl_lambda_ListFunctions(
                         interp,
-                        handle
+                        handlePtr
                 );
             case m_getFunction:
                 CheckArgs(3, 3, 1, "get_function function_name");
                 return aws_sdk_tcl_lambda_GetFunction(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_createFunction:
                 CheckArgs(7, 8, 1, "create_function function_name function_code_path handler runtime execution_role_arn ?timeout?");
                 return aws_sdk_tcl_lambda_CreateFunction(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
                         Tcl_GetString(objv[4]),
@@ -478,14 +514,14 @@ int aws_sdk_tcl_lambda_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, i
                 CheckArgs(3, 3, 1, "delete_function function_name");
                 return aws_sdk_tcl_lambda_DeleteFunction(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_invokeFunction:
                 CheckArgs(4, 5, 1, "invoke_function function_name payload_json ?invocation_type?");
                 return aws_sdk_tcl_lambda_InvokeFunction(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
                         objc == 5 ? Tcl_GetString(objv[4]) : nullptr
@@ -529,35 +565,54 @@ char *aws_sdk_tcl_lambda_VarTraceProc(ClientData clientData, Tcl_Interp *interp,
 static int aws_sdk_tcl_lambda_CreateCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "CreateCmd\n"));
 
-    CheckArgs(2, 3, 1, "config_dict ?varname?");
+    int shared = objc > 1 && 0 == strcmp(Tcl_GetString(objv[1]), "-shared");
+    CheckArgs(2 + shared, 3 + shared, 1, "?-shared? config_dict ?varname?");
 
-    auto result = get_client_config_and_credentials_provider(interp, objv[1]);
-    int status = std::get<0>(result);
-    if (TCL_OK != status) {
-        SetResult("Invalid config_dict");
-        return TCL_ERROR;
+    Aws::String key;
+    Aws::Lambda::LambdaClient *client = nullptr;
+    if (shared) {
+        if (TCL_OK != aws_sdk_tcl_GetSharedClientKey(interp, "lambda", objv[1 + shared], key)) {
+            return TCL_ERROR;
+        }
+        // the configuration and credentials are only set up for a new client
+        client = (Aws::Lambda::LambdaClient *) aws_sdk_tcl_FindSharedClient(key);
     }
-    Aws::Client::ClientConfiguration client_config = std::get<1>(result);
-    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+    if (!client) {
+        auto result = get_client_config_and_credentials_provider(interp, objv[1 + shared]);
+        int status = std::get<0>(result);
+        if (TCL_OK != status) {
+            return TCL_ERROR;
+        }
+        Aws::Client::ClientConfiguration client_config = std::get<1>(result);
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
 
-    auto *client = credentials_provider_ptr != nullptr ? new Aws::Lambda::LambdaClient(credentials_provider_ptr, client_config) : new Aws::Lambda::LambdaClient(client_config);
+        client = credentials_provider_ptr != nullptr ? new Aws::Lambda::LambdaClient(credentials_provider_ptr, client_config)
+                                                     : new Aws::Lambda::LambdaClient(client_config);
+        if (shared) {
+            client = (Aws::Lambda::LambdaClient *) aws_sdk_tcl_AddSharedClient(key, client, aws_sdk_tcl_lambda_DeleteClient);
+        }
+    }
     char handle[80];
-    CMD_NAME(handle, client);
-    aws_sdk_tcl_lambda_RegisterName(handle, client);
+    if (shared) {
+        SHARED_CMD_NAME(handle, client, aws_sdk_tcl_NewSharedHandleId());
+    } else {
+        CMD_NAME(handle, client);
+    }
+    ClientData handleRef = aws_sdk_tcl_lambda_RegisterName(handle, client);
 
     Tcl_CreateObjCommand(interp, handle,
                          (Tcl_ObjCmdProc *) aws_sdk_tcl_lambda_ClientObjCmd,
-                         nullptr,
-                         nullptr);
+                         handleRef,
+                         (Tcl_CmdDeleteProc *) aws_sdk_tcl_FreeHandleRef);
 //                                 (Tcl_CmdDeleteProc*) aws_sdk_tcl_lambda_clientObjCmdDeleteProc);
 
-    if (objc == 3) {
+    if (objc == 3 + shared) {
         auto *trace = (aws_sdk_tcl_lambda_trace_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_lambda_trace_t));
         trace->interp = interp;
-        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2]), 80);
+        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2 + shared]), 80);
         trace->handle = aws_sdk_strndup(handle, 80);
         trace->item = client;
-        const char *objVar = Tcl_GetString(objv[2]);
+        const char *objVar = Tcl_GetString(objv[2 + shared]);
         Tcl_UnsetVar(interp, objVar, 0);
         Tcl_SetVar  (interp, objVar, handle, 0);
         Tcl_TraceVar(interp,objVar,TCL_TRACE_WRITES|TCL_TRACE_UNSETS,
@@ -578,13 +633,13 @@ static int aws_sdk_tcl_lambda_DestroyCmd(ClientData clientData, Tcl_Interp *inte
 static int aws_sdk_tcl_lambda_ListFunctionsCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "ListFunctionsCmd\n"));
     CheckArgs(2, 2, 1, "handle_name");
-    return aws_sdk_tcl_lambda_ListFunctions(interp, Tcl_GetString(objv[1]));
+    return aws_sdk_tcl_lambda_ListFunctions(interp, objv[1]);
 }
 
 static int aws_sdk_tcl_lambda_GetFunctionCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "GetFunctionCmd\n"));
     CheckArgs(3, 3, 1, "handle_name function_name");
-    return aws_sdk_tcl_lambda_GetFunction(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_lambda_GetFunction(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_lambda_CreateFunctionCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
@@ -592,7 +647,7 @@ static int aws_sdk_tcl_lambda_CreateFunctionCmd(ClientData clientData, Tcl_Inter
     CheckArgs(7, 8, 1, "handle_name function_name function_code_path function_handler runtime execution_role_arn ?timeout?");
     return aws_sdk_tcl_lambda_CreateFunction(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             Tcl_GetString(objv[3]),
             Tcl_GetString(objv[4]),
@@ -607,7 +662,7 @@ static int aws_sdk_tcl_lambda_DeleteFunctionCmd(ClientData clientData, Tcl_Inter
     CheckArgs(3, 3, 1, "handle_name function_name");
     return aws_sdk_tcl_lambda_DeleteFunction(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2])
     );
 }
@@ -617,19 +672,18 @@ static int aws_sdk_tcl_lambda_InvokeFunctionCmd(ClientData clientData, Tcl_Inter
     CheckArgs(4, 5, 1, "handle_name function_name payload_json ?invocation_type?");
     return aws_sdk_tcl_lambda_InvokeFunction(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             Tcl_GetString(objv[3]),
             objc == 5 ? Tcl_GetString(objv[4]) : nullptr
     );
 }
 
-static Aws::SDKOptions options;
-
 static void aws_sdk_tcl_lambda_ExitHandler(ClientData unused) {
     Tcl_MutexLock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
     Tcl_DeleteHashTable(&aws_sdk_tcl_lambda_NameToInternal_HT);
-    Aws::ShutdownAPI(options);
+    aws_sdk_tcl_ShutdownAPI();
+    aws_sdk_tcl_lambda_ModuleInitialized = 0;
     Tcl_MutexUnlock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
 
 }
@@ -638,7 +692,7 @@ static void aws_sdk_tcl_lambda_ExitHandler(ClientData unused) {
 void aws_sdk_tcl_lambda_InitModule() {
     Tcl_MutexLock(&aws_sdk_tcl_lambda_NameToInternal_HT_Mutex);
     if (!aws_sdk_tcl_lambda_ModuleInitialized) {
-        Aws::InitAPI(options);
+        aws_sdk_tcl_InitAPI();
         Tcl_InitHashTable(&aws_sdk_tcl_lambda_NameToInternal_HT, TCL_STRING_KEYS);
         Tcl_CreateThreadExitHandler(aws_sdk_tcl_lambda_ExitHandler, nullptr);
         aws_sdk_tcl_lambda_ModuleInitialized = 1;
@@ -662,6 +716,7 @@ int Aws_sdk_tcl_lambda_Init(Tcl_Interp *interp) {
     aws_sdk_tcl_lambda_InitModule();
 
     Tcl_CreateNamespace(interp, "::aws::lambda", nullptr, nullptr);
+    aws_sdk_tcl_CreateCommonCmds(interp);
     Tcl_CreateObjCommand(interp, "::aws::lambda::create", aws_sdk_tcl_lambda_CreateCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::lambda::destroy", aws_sdk_tcl_lambda_DestroyCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::lambda::list_functions", aws_sdk_tcl_lambda_ListFunctionsCmd, nullptr, nullptr);
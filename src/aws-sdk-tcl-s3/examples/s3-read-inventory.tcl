@@ -0,0 +1,30 @@
+package require awss3
+
+# The bucket and the manifest written by an S3 Inventory configuration, e.g.
+# <prefix>/<source-bucket>/<config-id>/2023-10-01T01-00Z/manifest.json
+set bucket_name "my-inventory-bucket"
+set manifest_key "inventory/my-bucket/daily/2023-10-01T01-00Z/manifest.json"
+
+# To use it with real AWS S3, you can use the following configuration:
+# set config_dict [dict create region "us-east-1" aws_access_key_id "your_access_key_id" aws_secret_access_key "your_secret_access_key"]
+
+# To use it with localstack, you can use the following configuration:
+set config_dict [dict create endpoint "http://s3.localhost.localstack.cloud:4566"]
+
+# creates an S3 client
+::aws::s3::create $config_dict s3_client
+
+set total_size 0
+
+# called with a list of rows, each row is a dict keyed by the fields of the inventory schema
+proc process_batch {rows} {
+    global total_size
+    foreach row $rows {
+        incr total_size [dict get $row Size]
+    }
+}
+
+# reads the data files, eight at a time, and delivers the rows in batches of 5000
+set count [$s3_client read_inventory $bucket_name $manifest_key process_batch -batch-size 5000 -concurrency 8]
+
+puts "objects: $count total size: $total_size bytes"
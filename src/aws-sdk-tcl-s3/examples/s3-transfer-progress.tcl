@@ -0,0 +1,35 @@
+package require awss3
+
+set dir [file dirname [info script]]
+
+set bucket_name "my-bucket"
+
+# To use it with real AWS S3, you can use the following configuration:
+# set config_dict [dict create region "us-east-1" aws_access_key_id "your_access_key_id" aws_secret_access_key "your_secret_access_key"]
+
+# To use it with localstack, you can use the following configuration:
+set config_dict [dict create endpoint "http://s3.localhost.localstack.cloud:4566"]
+
+# creates an S3 client
+::aws::s3::create $config_dict s3_client
+
+# checks if the bucket exists already
+set exists_p [$s3_client exists_bucket $bucket_name]
+
+# creates the bucket if it does not exist
+if {!$exists_p} {
+    $s3_client create_bucket $bucket_name
+}
+
+# called with the bytes transferred so far, the total bytes and the current rate in bytes/sec
+proc report_progress {direction transferred total rate} {
+    puts "$direction: $transferred/$total bytes ($rate bytes/sec)"
+}
+
+# uploads a file and reports the progress at most every 100 milliseconds
+$s3_client put $bucket_name "my_logo.png" [file join $dir "Google_2015_logo.png"] \
+    -progress [list report_progress upload] -progress-interval 100
+
+# downloads the file and reports the progress
+$s3_client get $bucket_name "my_logo.png" /tmp/mylogo.png \
+    -progress [list report_progress download] -progress-interval 100
@@ -7,6 +7,7 @@
 #include <aws/core/Aws.h>
 #include <aws/core/auth/AWSCredentials.h>
 #include <aws/core/auth/AWSCredentialsProvider.h>
+#include <aws/core/utils/ratelimiter/DefaultRateLimiter.h>
 #include <aws/s3/S3Client.h>
 #include <aws/s3/model/ListObjectsRequest.h>
 #include "aws/s3/model/PutObjectRequest.h"
@@ -16,11 +17,32 @@
 #include <aws/s3/model/Object.h>
 #include <cstdio>
 #include <fstream>
+#include <chrono>
+#include <cstdlib>
+#include <climits>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <algorithm>
 #include <aws/s3/model/CreateBucketRequest.h>
 #include <aws/s3/model/DeleteBucketRequest.h>
 #include <aws/s3/model/HeadBucketRequest.h>
 #include <aws/s3/model/Delete.h>
 #include <aws/s3/model/DeleteObjectsRequest.h>
+#include <aws/s3/model/PutObjectTaggingRequest.h>
+#include <aws/s3/model/PutBucketLifecycleConfigurationRequest.h>
+#include <aws/s3/model/BucketLifecycleConfiguration.h>
+#include <aws/s3/model/LifecycleRule.h>
+#include <aws/s3/model/LifecycleRuleFilter.h>
+#include <aws/s3/model/LifecycleRuleAndOperator.h>
+#include <aws/s3/model/LifecycleExpiration.h>
+#include <aws/s3/model/NoncurrentVersionExpiration.h>
+#include <aws/s3/model/AbortIncompleteMultipartUpload.h>
+#include <aws/s3/model/Tagging.h>
+#include <aws/s3/model/Tag.h>
+#include <aws/core/utils/StringUtils.h>
+#include <aws/core/utils/json/JsonSerializer.h>
+#include <deque>
 #include "library.h"
 #include "../common/common.h"
 
@@ -48,6 +70,7 @@ typedef int Tcl_Size;
                  }
 
 #define CMD_NAME(s,internal) std::sprintf((s), "_AWS_S3_%p", (internal))
+#define SHARED_CMD_NAME(s, internal, id) std::sprintf((s), "_AWS_S3_%p_%lu", (internal), (id))
 
 static char VAR_READ_ONLY_MSG[] = "var is read-only";
 
@@ -58,25 +81,85 @@ typedef struct {
     Aws::S3::S3Client *item;
 } aws_sdk_tcl_s3_trace_t;
 
+// Per-handle state. The request limiter is a token bucket shared by all
+// requests issued through the same handle, regardless of the thread.
+// progress_ops counts the transfers that wait for their request while
+// calling a progress callback, the client cannot be destroyed meanwhile.
+// The configuration is kept for the clients of the -timeout values.
+typedef struct {
+    Aws::S3::S3Client *item;
+    std::shared_ptr<Aws::Utils::RateLimits::RateLimiterInterface> request_limiter;
+    std::atomic<int> progress_ops;
+    Aws::Client::ClientConfiguration config;
+    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider;
+    std::mutex timeout_clients_mutex;
+    Aws::Map<long, Aws::S3::S3Client *> timeout_clients;
+} aws_sdk_tcl_s3_client_t;
+
+typedef struct {
+    Tcl_Obj *progress_cmd;
+    Tcl_WideInt progress_interval_ms;
+    Tcl_Obj *token;
+    Tcl_WideInt timeout_ms;
+    Tcl_Obj *tags;
+} aws_sdk_tcl_s3_transfer_options_t;
+
+// Tokens are shared by all interpreters and threads of the process, so that
+// an operation can be cancelled from anywhere that knows the token name.
+// A token lives from create_token until release_token and the end of the
+// last operation that uses it, the table holds one of its references.
+typedef struct {
+    std::atomic<bool> cancelled;
+    int refCount;
+} aws_sdk_tcl_s3_token_t;
+
+// The counters are updated by the HTTP client on the thread that runs the
+// request and read by the thread of the interpreter, which reports them.
+typedef struct {
+    Tcl_Interp *interp;
+    Tcl_Obj *cmd;
+    std::chrono::milliseconds interval;
+    std::chrono::steady_clock::time_point last_report;
+    int64_t last_transferred;
+    std::atomic<int64_t> transferred;
+    std::atomic<int64_t> total;
+    std::atomic<bool> cancelled;
+} aws_sdk_tcl_s3_progress_t;
+
+typedef struct {
+    aws_sdk_tcl_s3_token_t *token;
+    aws_sdk_tcl_s3_progress_t *progress;
+    int has_deadline;
+    std::chrono::steady_clock::time_point deadline;
+} aws_sdk_tcl_s3_control_t;
+
 static Tcl_HashTable aws_sdk_tcl_s3_NameToInternal_HT;
 static Tcl_Mutex     aws_sdk_tcl_s3_NameToInternal_HT_Mutex;
 static int           aws_sdk_tcl_s3_ModuleInitialized;
 
+static Tcl_HashTable aws_sdk_tcl_s3_Tokens_HT;
+static Tcl_Mutex     aws_sdk_tcl_s3_Tokens_HT_Mutex;
+static unsigned long aws_sdk_tcl_s3_TokenCounter;
+
 static char s3_client_usage[] =
     "Usage s3Client <method> <args>, where method can be:\n"
-    "   ls bucket ?key?                 \n"
-    "   put_text bucket key text        \n"
-    "   put bucket key input_file       \n"
-    "   get bucket key ?output_file?    \n"
-    "   delete bucket key               \n"
-    "   batch_delete bucket keys        \n"
-    "   exists bucket key               \n"
-    "   create_bucket bucket            \n"
-    "   delete_bucket bucket            \n"
-    "   exists_bucket bucket            \n"
-    "   list_buckets                    \n"
-    "   generate_presigned_url          \n"
-    "   destroy                         \n"
+    "   ls bucket ?key?                                  \n"
+    "   put_text bucket key text ?options?               \n"
+    "   put bucket key input_file ?options?              \n"
+    "   get bucket key ?output_file? ?options?           \n"
+    "   delete bucket key                                \n"
+    "   batch_delete bucket keys                         \n"
+    "   exists bucket key                                \n"
+    "   create_bucket bucket                             \n"
+    "   delete_bucket bucket                             \n"
+    "   exists_bucket bucket                             \n"
+    "   list_buckets                                     \n"
+    "   generate_presigned_url                           \n"
+    "   put_tags bucket key tags_dict                    \n"
+    "   put_tags_many bucket key_tags_dict ?concurrency? \n"
+    "   put_bucket_lifecycle bucket rules                \n"
+    "   read_inventory bucket manifest_key cmd ?options? \n"
+    "   destroy                                          \n"
 ;
 
 typedef enum {
@@ -92,8 +175,8 @@ static const char *const aws_sdk_tcl_http_methods[] = {
     "GET", "POST", "DELETE", "PUT", "HEAD", "PATCH", NULL
 };
 
-static int
-aws_sdk_tcl_s3_RegisterName(const char *name, Aws::S3::S3Client *internal) {
+static ClientData
+aws_sdk_tcl_s3_RegisterName(const char *name, aws_sdk_tcl_s3_client_t *internal) {
 
     Tcl_HashEntry *entryPtr;
     int newEntry;
@@ -101,13 +184,15 @@ aws_sdk_tcl_s3_RegisterName(const char *name, Aws::S3::S3Client *internal) {
     Tcl_MutexLock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
     entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_s3_NameToInternal_HT, (char*) name, &newEntry);
     if (newEntry) {
-        Tcl_SetHashValue(entryPtr, (ClientData)internal);
+        Tcl_SetHashValue(entryPtr, (ClientData) aws_sdk_tcl_AllocSlot(&aws_sdk_tcl_s3_NameToInternal_HT, internal));
     }
+    // becomes the clientData of the handle command
+    ClientData handleRef = aws_sdk_tcl_NewHandleRef((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr), name);
     Tcl_MutexUnlock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
 
     DBG(fprintf(stderr, "--> RegisterName: name=%s internal=%p %s\n", name, internal, newEntry ? "entered into" : "already in"));
 
-    return !!newEntry;
+    return handleRef;
 }
 
 static int
@@ -118,6 +203,7 @@ aws_sdk_tcl_s3_UnregisterName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_s3_NameToInternal_HT, (char*)name);
     if (entryPtr != nullptr) {
+        aws_sdk_tcl_FreeSlot((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
         Tcl_DeleteHashEntry(entryPtr);
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
@@ -127,37 +213,499 @@ aws_sdk_tcl_s3_UnregisterName(const char *name) {
     return entryPtr != nullptr;
 }
 
-static struct Aws::S3::S3Client *
+static aws_sdk_tcl_s3_client_t *
 aws_sdk_tcl_s3_GetInternalFromName(const char *name) {
-    Aws::S3::S3Client *internal = nullptr;
+    aws_sdk_tcl_s3_client_t *internal = nullptr;
     Tcl_HashEntry *entryPtr;
 
     Tcl_MutexLock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_s3_NameToInternal_HT, (char*)name);
     if (entryPtr != nullptr) {
-        internal = (Aws::S3::S3Client *)Tcl_GetHashValue(entryPtr);
+        internal = (aws_sdk_tcl_s3_client_t *) aws_sdk_tcl_GetSlotItem((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
 
     return internal;
 }
 
+static aws_sdk_tcl_s3_client_t *
+aws_sdk_tcl_s3_GetInternalFromObj(Tcl_Obj *objPtr) {
+    // no locking once the object caches the slot of the handle
+    auto *internal = (aws_sdk_tcl_s3_client_t *) aws_sdk_tcl_GetCachedItem(objPtr, &aws_sdk_tcl_s3_NameToInternal_HT);
+    if (internal == nullptr) {
+        Tcl_HashEntry *entryPtr;
+
+        Tcl_MutexLock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
+        entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_s3_NameToInternal_HT, Tcl_GetString(objPtr));
+        if (entryPtr != nullptr) {
+            internal = (aws_sdk_tcl_s3_client_t *) aws_sdk_tcl_SetCachedItem(objPtr, (aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
+        }
+        Tcl_MutexUnlock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
+    }
+
+    return internal;
+}
+
+static struct Aws::S3::S3Client *
+aws_sdk_tcl_s3_GetClientFromObj(Tcl_Obj *objPtr) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(objPtr);
+    return internal != nullptr ? internal->item : nullptr;
+}
+
+static Aws::S3::S3Client *
+aws_sdk_tcl_s3_NewClient(const std::shared_ptr<Aws::Auth::AWSCredentialsProvider> &credentials_provider,
+                         const Aws::Client::ClientConfiguration &config) {
+    return credentials_provider != nullptr
+           ? new Aws::S3::S3Client(credentials_provider, Aws::MakeShared<Aws::S3::S3EndpointProvider>(Aws::S3::S3Client::ALLOCATION_TAG), config)
+           : new Aws::S3::S3Client(config);
+}
+
+// A -timeout is enforced by the HTTP client: the operation runs on a client
+// whose connect, read and whole request timeouts are capped to it, so that
+// neither a hung connect, nor a server that never answers, nor a stalled
+// body outlasts it by much. The HTTP timeouts are rounded up to a power of
+// two of milliseconds, at least 1024, so that a handle keeps a few dozen
+// clients at most whatever values it is given: a hang ends within twice the
+// timeout, while the exact deadline is checked by the continue handler. The
+// client of a bucket is created on first use and shares the credentials,
+// limits and executor of the handle.
+static Aws::S3::S3Client *
+aws_sdk_tcl_s3_GetTimeoutClient(aws_sdk_tcl_s3_client_t *internal, Tcl_WideInt timeout_ms) {
+    if (timeout_ms <= 0) {
+        return internal->item;
+    }
+    long bucket_ms = 1024;
+    while (bucket_ms < timeout_ms && bucket_ms <= LONG_MAX / 2) {
+        bucket_ms *= 2;
+    }
+    std::lock_guard<std::mutex> lock(internal->timeout_clients_mutex);
+    Aws::S3::S3Client *&client = internal->timeout_clients[bucket_ms];
+    if (client == nullptr) {
+        Aws::Client::ClientConfiguration config = internal->config;
+        config.httpRequestTimeoutMs = bucket_ms;
+        config.connectTimeoutMs = std::min(config.connectTimeoutMs, bucket_ms);
+        config.requestTimeoutMs = std::min(config.requestTimeoutMs, bucket_ms);
+        client = aws_sdk_tcl_s3_NewClient(internal->credentials_provider, config);
+    }
+    return client;
+}
+
+// Called right before every request the handle sends, once per request
+// for the commands that send many of them.
+static void
+aws_sdk_tcl_s3_ApplyRequestLimit(aws_sdk_tcl_s3_client_t *internal) {
+    if (internal->request_limiter) {
+        // blocks the calling thread until a token is available
+        internal->request_limiter->ApplyAndPayForCost(1);
+    }
+}
+
+static const char *const aws_sdk_tcl_s3_transfer_options[] = {
+    "-progress", "-progress-interval", "-token", "-timeout", "-tags", NULL
+};
+
+// The optional filename of get is told apart from the options by name, a
+// file named like one of the options has to be given with a path, e.g. ./-tags.
+static int
+aws_sdk_tcl_s3_IsTransferOption(Tcl_Obj *objPtr) {
+    const char *arg = Tcl_GetString(objPtr);
+    for (int i = 0; aws_sdk_tcl_s3_transfer_options[i] != NULL; i++) {
+        if (0 == strcmp(arg, aws_sdk_tcl_s3_transfer_options[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int
+aws_sdk_tcl_s3_GetTransferOptions(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], aws_sdk_tcl_s3_transfer_options_t *opts) {
+    const char *const *options = aws_sdk_tcl_s3_transfer_options;
+    enum options { OPT_PROGRESS, OPT_PROGRESS_INTERVAL, OPT_TOKEN, OPT_TIMEOUT, OPT_TAGS };
+
+    opts->progress_cmd = nullptr;
+    opts->progress_interval_ms = 1000;
+    opts->token = nullptr;
+    opts->timeout_ms = 0;
+    opts->tags = nullptr;
+
+    for (int i = 0; i < objc; i++) {
+        int option;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (++i == objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("missing value for option \"%s\"", Tcl_GetString(objv[i - 1])));
+            return TCL_ERROR;
+        }
+        switch ((enum options) option) {
+        case OPT_PROGRESS:
+            opts->progress_cmd = objv[i];
+            break;
+        case OPT_PROGRESS_INTERVAL:
+            if (Tcl_GetWideIntFromObj(interp, objv[i], &opts->progress_interval_ms) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (opts->progress_interval_ms < 0) {
+                Tcl_SetObjResult(interp, Tcl_ObjPrintf("unsigned integer >= 0 is expected,"
+                    " but got \"%s\"", Tcl_GetString(objv[i])));
+                return TCL_ERROR;
+            }
+            break;
+        case OPT_TOKEN:
+            opts->token = objv[i];
+            break;
+        case OPT_TAGS:
+            opts->tags = objv[i];
+            break;
+        case OPT_TIMEOUT:
+            if (Tcl_GetWideIntFromObj(interp, objv[i], &opts->timeout_ms) != TCL_OK) {
+                return TCL_ERROR;
+            }
+            if (opts->timeout_ms < 0) {
+                Tcl_SetObjResult(interp, Tcl_ObjPrintf("unsigned integer >= 0 is expected,"
+                    " but got \"%s\"", Tcl_GetString(objv[i])));
+                return TCL_ERROR;
+            }
+            break;
+        }
+    }
+    return TCL_OK;
+}
+
+static void
+aws_sdk_tcl_s3_ProgressInit(aws_sdk_tcl_s3_progress_t *progress, Tcl_Interp *interp, aws_sdk_tcl_s3_transfer_options_t *opts) {
+    progress->interp = interp;
+    progress->cmd = opts->progress_cmd;
+    // the interval is also the period the request is polled with
+    progress->interval = std::chrono::milliseconds(std::max<Tcl_WideInt>(opts->progress_interval_ms, 10));
+    progress->last_report = std::chrono::steady_clock::now();
+    progress->last_transferred = 0;
+    progress->transferred = 0;
+    progress->total = -1;
+    progress->cancelled = false;
+}
+
+static void
+aws_sdk_tcl_s3_ProgressReport(aws_sdk_tcl_s3_progress_t *progress, std::chrono::steady_clock::time_point now) {
+    int64_t transferred = progress->transferred;
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - progress->last_report).count();
+    // a retry starts over, the count goes back and the rate is not negative
+    Tcl_WideInt rate = elapsed_ms > 0 && transferred > progress->last_transferred
+            ? (Tcl_WideInt) ((transferred - progress->last_transferred) * 1000 / elapsed_ms) : 0;
+    progress->last_report = now;
+    progress->last_transferred = transferred;
+
+    Tcl_Obj *cmdPtr = Tcl_DuplicateObj(progress->cmd);
+    Tcl_IncrRefCount(cmdPtr);
+    Tcl_ListObjAppendElement(progress->interp, cmdPtr, Tcl_NewWideIntObj(transferred));
+    Tcl_ListObjAppendElement(progress->interp, cmdPtr, Tcl_NewWideIntObj(progress->total));
+    Tcl_ListObjAppendElement(progress->interp, cmdPtr, Tcl_NewWideIntObj(rate));
+    Tcl_Preserve(progress->interp);
+    int rc = Tcl_EvalObjEx(progress->interp, cmdPtr, TCL_EVAL_GLOBAL);
+    if (rc == TCL_BREAK) {
+        // the callback gave up on the transfer, e.g. because it stalled
+        progress->cancelled = true;
+    } else if (rc != TCL_OK) {
+        Tcl_BackgroundException(progress->interp, rc);
+    }
+    Tcl_Release(progress->interp);
+    Tcl_DecrRefCount(cmdPtr);
+}
+
+// Called by the HTTP client on the thread that runs the request, it only
+// counts, the report is made by the thread of the interpreter.
+static void
+aws_sdk_tcl_s3_ProgressUpdate(aws_sdk_tcl_s3_progress_t *progress, int64_t bytes) {
+    progress->transferred += bytes;
+}
+
+// A retried request transfers its body again from the start.
+static void
+aws_sdk_tcl_s3_ProgressAttach(aws_sdk_tcl_s3_progress_t *progress, Aws::AmazonWebServiceRequest &request) {
+    request.SetRequestRetryHandler([progress](const Aws::AmazonWebServiceRequest &) {
+        progress->transferred = 0;
+    });
+}
+
+static void
+aws_sdk_tcl_s3_ProgressFinish(aws_sdk_tcl_s3_progress_t *progress) {
+    if (progress->total < 0) {
+        progress->total = progress->transferred.load();
+    }
+    aws_sdk_tcl_s3_ProgressReport(progress, std::chrono::steady_clock::now());
+}
+
+// Waits for a request that runs on the executor of the client, reporting
+// the progress every interval, whether bytes moved or not, so that a
+// stalled transfer is reported too. The callback runs on the thread of the
+// interpreter, outside of the HTTP client.
+template<typename Outcome>
+static Outcome
+aws_sdk_tcl_s3_WaitForOutcome(aws_sdk_tcl_s3_client_t *internal, aws_sdk_tcl_s3_progress_t *progress, std::future<Outcome> future) {
+    internal->progress_ops++;
+    while (future.wait_for(progress->interval) != std::future_status::ready) {
+        aws_sdk_tcl_s3_ProgressReport(progress, std::chrono::steady_clock::now());
+    }
+    internal->progress_ops--;
+    return future.get();
+}
+
+static void
+aws_sdk_tcl_s3_CreateToken(char *name) {
+    Tcl_HashEntry *entryPtr;
+    int newEntry;
+
+    auto *token = new aws_sdk_tcl_s3_token_t;
+    token->cancelled = false;
+    token->refCount = 1;
+
+    Tcl_MutexLock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+    std::sprintf(name, "_AWS_S3_TOKEN_%lu", ++aws_sdk_tcl_s3_TokenCounter);
+    entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_s3_Tokens_HT, name, &newEntry);
+    Tcl_SetHashValue(entryPtr, (ClientData) token);
+    Tcl_MutexUnlock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+}
+
+static aws_sdk_tcl_s3_token_t *
+aws_sdk_tcl_s3_AcquireToken(const char *name) {
+    Tcl_HashEntry *entryPtr;
+    aws_sdk_tcl_s3_token_t *token = nullptr;
+
+    Tcl_MutexLock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+    entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_s3_Tokens_HT, (char*) name);
+    if (entryPtr != nullptr) {
+        token = (aws_sdk_tcl_s3_token_t *) Tcl_GetHashValue(entryPtr);
+        token->refCount++;
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+
+    return token;
+}
+
+static void
+aws_sdk_tcl_s3_ReleaseToken(aws_sdk_tcl_s3_token_t *token) {
+    Tcl_MutexLock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+    if (--token->refCount == 0) {
+        delete token;
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+}
+
+// Removes the token from the table, the operations that use it keep it.
+static int
+aws_sdk_tcl_s3_DeleteToken(const char *name) {
+    Tcl_HashEntry *entryPtr;
+    aws_sdk_tcl_s3_token_t *token = nullptr;
+
+    Tcl_MutexLock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+    entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_s3_Tokens_HT, (char*) name);
+    if (entryPtr != nullptr) {
+        token = (aws_sdk_tcl_s3_token_t *) Tcl_GetHashValue(entryPtr);
+        Tcl_DeleteHashEntry(entryPtr);
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+
+    if (token != nullptr) {
+        aws_sdk_tcl_s3_ReleaseToken(token);
+    }
+    return token != nullptr;
+}
+
+static int
+aws_sdk_tcl_s3_CancelToken(const char *name) {
+    Tcl_HashEntry *entryPtr;
+
+    Tcl_MutexLock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+    entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_s3_Tokens_HT, (char*) name);
+    if (entryPtr != nullptr) {
+        ((aws_sdk_tcl_s3_token_t *) Tcl_GetHashValue(entryPtr))->cancelled = true;
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+
+    return entryPtr != nullptr;
+}
+
+static void
+aws_sdk_tcl_s3_ControlRelease(aws_sdk_tcl_s3_control_t *control) {
+    if (control->token) {
+        aws_sdk_tcl_s3_ReleaseToken(control->token);
+        control->token = nullptr;
+    }
+}
+
+// Fails when the token does not exist or has already been cancelled, in
+// which case the operation is not started.
+static int
+aws_sdk_tcl_s3_ControlInit(Tcl_Interp *interp, aws_sdk_tcl_s3_control_t *control, aws_sdk_tcl_s3_transfer_options_t *opts, aws_sdk_tcl_s3_progress_t *progress) {
+    control->token = nullptr;
+    control->progress = opts->progress_cmd ? progress : nullptr;
+    control->has_deadline = opts->timeout_ms > 0;
+    if (control->has_deadline) {
+        control->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(opts->timeout_ms);
+    }
+    if (opts->token) {
+        control->token = aws_sdk_tcl_s3_AcquireToken(Tcl_GetString(opts->token));
+        if (control->token == nullptr) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("token not found: %s", Tcl_GetString(opts->token)));
+            return TCL_ERROR;
+        }
+        if (control->token->cancelled) {
+            aws_sdk_tcl_s3_ControlRelease(control);
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("operation cancelled", -1));
+            Tcl_SetErrorCode(interp, "AWS", "S3", "OperationCancelled", "-1", "0", "", NULL);
+            return TCL_ERROR;
+        }
+    }
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_s3_ControlIsCancelled(aws_sdk_tcl_s3_control_t *control) {
+    return (control->token && control->token->cancelled) || (control->progress && control->progress->cancelled);
+}
+
+static int
+aws_sdk_tcl_s3_ControlIsExpired(aws_sdk_tcl_s3_control_t *control) {
+    return control->has_deadline && std::chrono::steady_clock::now() >= control->deadline;
+}
+
+// The continue handler is consulted by the HTTP client whenever it reads or
+// writes a chunk of the body, and by the SDK before a retry, returning
+// false aborts the request. A request that hangs without moving data is
+// bounded by the timeout of its client, see aws_sdk_tcl_s3_GetTimeoutClient.
+static void
+aws_sdk_tcl_s3_ControlAttach(aws_sdk_tcl_s3_control_t *control, Aws::AmazonWebServiceRequest &request) {
+    if (control->token || control->progress || control->has_deadline) {
+        request.SetContinueRequestHandler([control](const Aws::Http::HttpRequest *) {
+            return !aws_sdk_tcl_s3_ControlIsCancelled(control) && !aws_sdk_tcl_s3_ControlIsExpired(control);
+        });
+    }
+}
+
+static void
+aws_sdk_tcl_s3_ControlSetError(Tcl_Interp *interp, aws_sdk_tcl_s3_control_t *control, const Aws::S3::S3Error &error) {
+    if (aws_sdk_tcl_s3_ControlIsCancelled(control)) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("operation cancelled", -1));
+        Tcl_SetErrorCode(interp, "AWS", "S3", "OperationCancelled", "-1", "0", "", NULL);
+    } else if (aws_sdk_tcl_s3_ControlIsExpired(control)) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("operation timed out", -1));
+        Tcl_SetErrorCode(interp, "AWS", "S3", "OperationTimedOut", "-1", "1", "", NULL);
+    } else {
+        aws_sdk_tcl_SetErrorResult(interp, "S3", error);
+    }
+}
+
+static int
+aws_sdk_tcl_s3_GetInventoryOptions(Tcl_Interp *interp, int objc, Tcl_Obj *const objv[], int *batch_size, int *concurrency) {
+    static const char *const options[] = { "-batch-size", "-concurrency", NULL };
+    enum options { OPT_BATCH_SIZE, OPT_CONCURRENCY };
+
+    *batch_size = 1000;
+    *concurrency = 4;
+
+    for (int i = 0; i < objc; i++) {
+        int option;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (++i == objc) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("missing value for option \"%s\"", Tcl_GetString(objv[i - 1])));
+            return TCL_ERROR;
+        }
+        int value;
+        if (Tcl_GetIntFromObj(interp, objv[i], &value) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (value < 1) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("integer >= 1 is expected,"
+                " but got \"%s\"", Tcl_GetString(objv[i])));
+            return TCL_ERROR;
+        }
+        switch ((enum options) option) {
+        case OPT_BATCH_SIZE:
+            *batch_size = value;
+            break;
+        case OPT_CONCURRENCY:
+            *concurrency = value;
+            break;
+        }
+    }
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_s3_GetTagSet(Tcl_Interp *interp, Tcl_Obj *dictPtr, Aws::Vector<Aws::S3::Model::Tag> &tagSet) {
+    Tcl_DictSearch search;
+    Tcl_Obj *key, *value;
+    int done;
+    if (Tcl_DictObjFirst(interp, dictPtr, &search, &key, &value, &done) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    for (; !done; Tcl_DictObjNext(&search, &key, &value, &done)) {
+        tagSet.push_back(Aws::S3::Model::Tag().WithKey(Tcl_GetString(key)).WithValue(Tcl_GetString(value)));
+    }
+    Tcl_DictObjDone(&search);
+    return TCL_OK;
+}
+
+// Tags given on upload are sent in the x-amz-tagging header as a URL query string.
+static int
+aws_sdk_tcl_s3_GetTagging(Tcl_Interp *interp, Tcl_Obj *dictPtr, Aws::String &tagging) {
+    Aws::Vector<Aws::S3::Model::Tag> tagSet;
+    if (TCL_OK != aws_sdk_tcl_s3_GetTagSet(interp, dictPtr, tagSet)) {
+        return TCL_ERROR;
+    }
+    for (const auto &tag: tagSet) {
+        if (!tagging.empty()) {
+            tagging.append("&");
+        }
+        tagging.append(Aws::Utils::StringUtils::URLEncode(tag.GetKey().c_str()));
+        tagging.append("=");
+        tagging.append(Aws::Utils::StringUtils::URLEncode(tag.GetValue().c_str()));
+    }
+    return TCL_OK;
+}
+
+static void
+aws_sdk_tcl_s3_DeleteClient(void *clientData) {
+    auto *internal = (aws_sdk_tcl_s3_client_t *) clientData;
+    for (auto &timeout_client: internal->timeout_clients) {
+        Aws::S3::S3Client::ShutdownSdkClient(timeout_client.second, -1);
+        delete timeout_client.second;
+    }
+    Aws::S3::S3Client::ShutdownSdkClient(internal->item, -1);
+    delete internal->item;
+    delete internal;
+}
+
 int aws_sdk_tcl_s3_Destroy(Tcl_Interp *interp, const char *handle) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromName(handle);
+    if (!internal) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+    // e.g. destroyed from a progress callback, the shutdown of the client
+    // would wait for the transfer that is waiting for the callback
+    if (internal->progress_ops > 0) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle is in use by a transfer in progress", -1));
+        return TCL_ERROR;
+    }
     if (!aws_sdk_tcl_s3_UnregisterName(handle)) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
-    Aws::S3::S3Client::ShutdownSdkClient(client, -1);
-    delete client;
+    // a shared client is only destroyed with its last handle
+    if (aws_sdk_tcl_ReleaseSharedClient(internal)) {
+        aws_sdk_tcl_s3_DeleteClient(internal);
+    }
     Tcl_DeleteCommand(interp, handle);
     Tcl_SetObjResult(interp, Tcl_NewStringObj(handle, -1));
     return TCL_OK;
 }
 
-int aws_sdk_tcl_s3_GeneratePresignedUrl(Tcl_Interp *interp, const char *handle, const char *bucket_name, const char *key_name, aws_sdk_tcl_http_method http_method, Tcl_WideInt expiration_seconds) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_s3_GeneratePresignedUrl: handle=%s bucket_name=%s key_name=%s http_method=%d\n", handle, bucket_name, key_name, (int)http_method));
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
+int aws_sdk_tcl_s3_GeneratePresignedUrl(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name, aws_sdk_tcl_http_method http_method, Tcl_WideInt expiration_seconds) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_s3_GeneratePresignedUrl: handle=%s bucket_name=%s key_name=%s http_method=%d\n", Tcl_GetString(handlePtr), bucket_name, key_name, (int)http_method));
+    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetClientFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -195,13 +743,14 @@ int aws_sdk_tcl_s3_GeneratePresignedUrl(Tcl_Interp *interp, const char *handle,
     return TCL_OK;
 }
 
-int aws_sdk_tcl_s3_List(Tcl_Interp *interp, const char *handle, const char *bucket_name, const char *key_name) {
-    DBG(fprintf(stderr, "aws_sdk_tcl_s3_List: handle=%s bucket_name=%s key_name=%s\n", handle, bucket_name, key_name));
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_List(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name) {
+    DBG(fprintf(stderr, "aws_sdk_tcl_s3_List: handle=%s bucket_name=%s key_name=%s\n", Tcl_GetString(handlePtr), bucket_name, key_name));
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
 
@@ -212,10 +761,11 @@ int aws_sdk_tcl_s3_List(Tcl_Interp *interp, const char *handle, const char *buck
         request.WithPrefix(key);
     }
 
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     auto outcome = client->ListObjects(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
         return TCL_ERROR;
     }
     else {
@@ -231,13 +781,14 @@ int aws_sdk_tcl_s3_List(Tcl_Interp *interp, const char *handle, const char *buck
     }
 }
 
-int aws_sdk_tcl_s3_PutText(Tcl_Interp *interp, const char *handle, const char *bucket_name, const char *key_name, const char *text) {
-    DBG(fprintf(stderr, "PutText: handle=%s bucket_name=%s key_name=%s text=%s\n", handle, bucket_name, key_name, text));
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_PutText(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name, const char *text, aws_sdk_tcl_s3_transfer_options_t *opts) {
+    DBG(fprintf(stderr, "PutText: handle=%s bucket_name=%s key_name=%s text=%s\n", Tcl_GetString(handlePtr), bucket_name, key_name, text));
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
     const Aws::String key = key_name;
@@ -250,25 +801,58 @@ int aws_sdk_tcl_s3_PutText(Tcl_Interp *interp, const char *handle, const char *b
     request.SetBucket(bucket);
     request.SetKey(key);
     request.SetBody(inputData);
-    Aws::S3::Model::PutObjectOutcome outcome = client->PutObject(request);
+    if (opts->tags) {
+        Aws::String tagging;
+        if (TCL_OK != aws_sdk_tcl_s3_GetTagging(interp, opts->tags, tagging)) {
+            return TCL_ERROR;
+        }
+        request.SetTagging(tagging);
+    }
+
+    aws_sdk_tcl_s3_progress_t progress;
+    if (opts->progress_cmd) {
+        aws_sdk_tcl_s3_ProgressInit(&progress, interp, opts);
+        progress.total = (int64_t) strlen(text);
+        request.SetDataSentEventHandler([&progress](const Aws::Http::HttpRequest *, long long amount) {
+            aws_sdk_tcl_s3_ProgressUpdate(&progress, amount);
+        });
+        aws_sdk_tcl_s3_ProgressAttach(&progress, request);
+    }
+    aws_sdk_tcl_s3_control_t control;
+    if (TCL_OK != aws_sdk_tcl_s3_ControlInit(interp, &control, opts, &progress)) {
+        return TCL_ERROR;
+    }
+    aws_sdk_tcl_s3_ControlAttach(&control, request);
+    client = aws_sdk_tcl_s3_GetTimeoutClient(internal, opts->timeout_ms);
+
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+    Aws::S3::Model::PutObjectOutcome outcome = opts->progress_cmd
+            ? aws_sdk_tcl_s3_WaitForOutcome(internal, &progress, client->PutObjectCallable(request))
+            : client->PutObject(request);
 
     inputData->clear();
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_s3_ControlSetError(interp, &control, outcome.GetError());
+        aws_sdk_tcl_s3_ControlRelease(&control);
         return TCL_ERROR;
     } else {
+        aws_sdk_tcl_s3_ControlRelease(&control);
+        if (opts->progress_cmd) {
+            aws_sdk_tcl_s3_ProgressFinish(&progress);
+        }
         return TCL_OK;
     }
 }
 
-int aws_sdk_tcl_s3_PutChannel(Tcl_Interp *interp, const char *handle, const char *bucket_name, const char *key_name, const char *filename) {
+int aws_sdk_tcl_s3_PutChannel(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name, const char *filename, aws_sdk_tcl_s3_transfer_options_t *opts) {
 
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
     const Aws::String key = key_name;
@@ -306,21 +890,60 @@ int aws_sdk_tcl_s3_PutChannel(Tcl_Interp *interp, const char *handle, const char
     request.SetBucket(bucket);
     request.SetKey(key);
     request.SetBody(inputData);
-    Aws::S3::Model::PutObjectOutcome outcome = client->PutObject(request);
+    if (opts->tags) {
+        Aws::String tagging;
+        if (TCL_OK != aws_sdk_tcl_s3_GetTagging(interp, opts->tags, tagging)) {
+            return TCL_ERROR;
+        }
+        request.SetTagging(tagging);
+    }
+
+    aws_sdk_tcl_s3_progress_t progress;
+    if (opts->progress_cmd) {
+        aws_sdk_tcl_s3_ProgressInit(&progress, interp, opts);
+        inputData->seekg(0, std::ios_base::end);
+        progress.total = (int64_t) inputData->tellg();
+        inputData->seekg(0, std::ios_base::beg);
+        request.SetDataSentEventHandler([&progress](const Aws::Http::HttpRequest *, long long amount) {
+            aws_sdk_tcl_s3_ProgressUpdate(&progress, amount);
+        });
+        aws_sdk_tcl_s3_ProgressAttach(&progress, request);
+    }
+    aws_sdk_tcl_s3_control_t control;
+    if (TCL_OK != aws_sdk_tcl_s3_ControlInit(interp, &control, opts, &progress)) {
+        return TCL_ERROR;
+    }
+    aws_sdk_tcl_s3_ControlAttach(&control, request);
+    client = aws_sdk_tcl_s3_GetTimeoutClient(internal, opts->timeout_ms);
+
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+    Aws::S3::Model::PutObjectOutcome outcome = opts->progress_cmd
+            ? aws_sdk_tcl_s3_WaitForOutcome(internal, &progress, client->PutObjectCallable(request))
+            : client->PutObject(request);
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_s3_ControlSetError(interp, &control, outcome.GetError());
+        aws_sdk_tcl_s3_ControlRelease(&control);
         return TCL_ERROR;
     } else {
+        aws_sdk_tcl_s3_ControlRelease(&control);
+        if (opts->progress_cmd) {
+            aws_sdk_tcl_s3_ProgressFinish(&progress);
+        }
         return TCL_OK;
     }
 }
 
-int aws_sdk_tcl_s3_Get(Tcl_Interp *interp, const char *handle, const char *bucket_name, const char *key_name, const char *filename) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_Get(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name, const char *filename, aws_sdk_tcl_s3_transfer_options_t *opts) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
+    if (opts->tags) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("option \"-tags\" is not supported by get", -1));
+        return TCL_ERROR;
+    }
 
     const Aws::String bucket = bucket_name;
     const Aws::String key = key_name;
@@ -329,13 +952,38 @@ int aws_sdk_tcl_s3_Get(Tcl_Interp *interp, const char *handle, const char *bucke
     request.SetBucket(bucket);
     request.SetKey(key);
 
-    Aws::S3::Model::GetObjectOutcome outcome =
-            client->GetObject(request);
+    aws_sdk_tcl_s3_progress_t progress;
+    if (opts->progress_cmd) {
+        aws_sdk_tcl_s3_ProgressInit(&progress, interp, opts);
+        request.SetDataReceivedEventHandler([&progress](const Aws::Http::HttpRequest *, Aws::Http::HttpResponse *response, long long amount) {
+            if (progress.total < 0 && response->HasHeader("content-length")) {
+                progress.total = std::atoll(response->GetHeader("content-length").c_str());
+            }
+            aws_sdk_tcl_s3_ProgressUpdate(&progress, amount);
+        });
+        aws_sdk_tcl_s3_ProgressAttach(&progress, request);
+    }
+    aws_sdk_tcl_s3_control_t control;
+    if (TCL_OK != aws_sdk_tcl_s3_ControlInit(interp, &control, opts, &progress)) {
+        return TCL_ERROR;
+    }
+    aws_sdk_tcl_s3_ControlAttach(&control, request);
+    client = aws_sdk_tcl_s3_GetTimeoutClient(internal, opts->timeout_ms);
+
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+    Aws::S3::Model::GetObjectOutcome outcome = opts->progress_cmd
+            ? aws_sdk_tcl_s3_WaitForOutcome(internal, &progress, client->GetObjectCallable(request))
+            : client->GetObject(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_s3_ControlSetError(interp, &control, outcome.GetError());
+        aws_sdk_tcl_s3_ControlRelease(&control);
         return TCL_ERROR;
     } else {
+        aws_sdk_tcl_s3_ControlRelease(&control);
+        if (opts->progress_cmd) {
+            aws_sdk_tcl_s3_ProgressFinish(&progress);
+        }
         Aws::IOStream &body = outcome.GetResult().GetBody();
         if (filename) {
             std::ofstream ofs;
@@ -356,12 +1004,13 @@ int aws_sdk_tcl_s3_Get(Tcl_Interp *interp, const char *handle, const char *bucke
     }
 }
 
-int aws_sdk_tcl_s3_Delete(Tcl_Interp *interp, const char *handle, const char *bucket_name, const char *key_name) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_Delete(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
     const Aws::String key = key_name;
@@ -371,23 +1020,25 @@ int aws_sdk_tcl_s3_Delete(Tcl_Interp *interp, const char *handle, const char *bu
     request.WithKey(key)
             .WithBucket(bucket);
 
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     Aws::S3::Model::DeleteObjectOutcome outcome =
             client->DeleteObject(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
         return TCL_ERROR;
     } else {
         return TCL_OK;
     }
 }
 
-int aws_sdk_tcl_s3_BatchDelete(Tcl_Interp *interp, const char *handle, const char *bucket_name, Tcl_Obj *listPtr) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_BatchDelete(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, Tcl_Obj *listPtr) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
     Aws::S3::Model::DeleteObjectsRequest request;
@@ -405,23 +1056,480 @@ int aws_sdk_tcl_s3_BatchDelete(Tcl_Interp *interp, const char *handle, const cha
     request.SetDelete(deleteObject);
     request.SetBucket(bucket);
 
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     Aws::S3::Model::DeleteObjectsOutcome outcome =
             client->DeleteObjects(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
         return TCL_ERROR;
     } else {
         return TCL_OK;
     }
 }
 
-int aws_sdk_tcl_s3_Exists(Tcl_Interp *interp, const char *handle, const char *bucket_name, const char *key_name) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_PutTags(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name, Tcl_Obj *tagsDictPtr) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
+
+    const Aws::String bucket = bucket_name;
+    const Aws::String key = key_name;
+
+    Aws::Vector<Aws::S3::Model::Tag> tagSet;
+    if (TCL_OK != aws_sdk_tcl_s3_GetTagSet(interp, tagsDictPtr, tagSet)) {
+        return TCL_ERROR;
+    }
+
+    Aws::S3::Model::PutObjectTaggingRequest request;
+    request.WithBucket(bucket)
+            .WithKey(key)
+            .WithTagging(Aws::S3::Model::Tagging().WithTagSet(tagSet));
+
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+    Aws::S3::Model::PutObjectTaggingOutcome outcome =
+            client->PutObjectTagging(request);
+
+    if (!outcome.IsSuccess()) {
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
+        return TCL_ERROR;
+    } else {
+        return TCL_OK;
+    }
+}
+
+// Tags many objects with at most "concurrency" requests in flight. The
+// requests run on the executor of the client and the result is a dict
+// of the keys that failed, mapped to their error message.
+int aws_sdk_tcl_s3_PutTagsMany(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, Tcl_Obj *dictPtr, int concurrency) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+    Aws::S3::S3Client *client = internal->item;
+
+    const Aws::String bucket = bucket_name;
+
+    Aws::Vector<Aws::S3::Model::PutObjectTaggingRequest> requests;
+    Tcl_DictSearch search;
+    Tcl_Obj *key, *tags;
+    int done;
+    if (Tcl_DictObjFirst(interp, dictPtr, &search, &key, &tags, &done) != TCL_OK) {
+        return TCL_ERROR;
+    }
+    for (; !done; Tcl_DictObjNext(&search, &key, &tags, &done)) {
+        Aws::Vector<Aws::S3::Model::Tag> tagSet;
+        if (TCL_OK != aws_sdk_tcl_s3_GetTagSet(interp, tags, tagSet)) {
+            Tcl_DictObjDone(&search);
+            return TCL_ERROR;
+        }
+        Aws::S3::Model::PutObjectTaggingRequest request;
+        request.WithBucket(bucket)
+                .WithKey(Tcl_GetString(key))
+                .WithTagging(Aws::S3::Model::Tagging().WithTagSet(tagSet));
+        requests.push_back(request);
+    }
+    Tcl_DictObjDone(&search);
+
+    Tcl_Obj *failedDictPtr = Tcl_NewDictObj();
+    std::deque<std::pair<size_t, Aws::S3::Model::PutObjectTaggingOutcomeCallable>> inflight;
+    size_t next = 0;
+    while (next < requests.size() || !inflight.empty()) {
+        while (next < requests.size() && inflight.size() < (size_t) concurrency) {
+            aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+            inflight.emplace_back(next, client->PutObjectTaggingCallable(requests[next]));
+            next++;
+        }
+        auto &oldest = inflight.front();
+        Aws::S3::Model::PutObjectTaggingOutcome outcome = oldest.second.get();
+        if (!outcome.IsSuccess()) {
+            Tcl_DictObjPut(interp, failedDictPtr,
+                           Tcl_NewStringObj(requests[oldest.first].GetKey().c_str(), -1),
+                           Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        }
+        inflight.pop_front();
+    }
+
+    Tcl_SetObjResult(interp, failedDictPtr);
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_s3_GetLifecycleRule(Tcl_Interp *interp, Tcl_Obj *ruleDictPtr, Aws::S3::Model::LifecycleRule &rule) {
+    static const char *const statuses[] = { "Enabled", "Disabled", NULL };
+    Tcl_Obj *idPtr, *prefixPtr, *tagsPtr, *statusPtr, *expirationDaysPtr, *noncurrentDaysPtr, *abortDaysPtr;
+
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, ruleDictPtr, "id", &idPtr)
+        || TCL_OK != aws_sdk_tcl_DictGet(interp, ruleDictPtr, "prefix", &prefixPtr)
+        || TCL_OK != aws_sdk_tcl_DictGet(interp, ruleDictPtr, "tags", &tagsPtr)
+        || TCL_OK != aws_sdk_tcl_DictGet(interp, ruleDictPtr, "status", &statusPtr)
+        || TCL_OK != aws_sdk_tcl_DictGet(interp, ruleDictPtr, "expiration_days", &expirationDaysPtr)
+        || TCL_OK != aws_sdk_tcl_DictGet(interp, ruleDictPtr, "noncurrent_expiration_days", &noncurrentDaysPtr)
+        || TCL_OK != aws_sdk_tcl_DictGet(interp, ruleDictPtr, "abort_incomplete_multipart_days", &abortDaysPtr)) {
+        return TCL_ERROR;
+    }
+
+    if (idPtr) {
+        rule.SetID(Tcl_GetString(idPtr));
+    }
+
+    int status = 0;
+    if (statusPtr && TCL_OK != Tcl_GetIndexFromObj(interp, statusPtr, statuses, "status", 0, &status)) {
+        return TCL_ERROR;
+    }
+    rule.SetStatus(status == 0 ? Aws::S3::Model::ExpirationStatus::Enabled : Aws::S3::Model::ExpirationStatus::Disabled);
+
+    Aws::Vector<Aws::S3::Model::Tag> tagSet;
+    if (tagsPtr && TCL_OK != aws_sdk_tcl_s3_GetTagSet(interp, tagsPtr, tagSet)) {
+        return TCL_ERROR;
+    }
+    Aws::String prefix = prefixPtr ? Tcl_GetString(prefixPtr) : "";
+    Aws::S3::Model::LifecycleRuleFilter filter;
+    if (tagSet.size() > 1 || (!tagSet.empty() && !prefix.empty())) {
+        filter.SetAnd(Aws::S3::Model::LifecycleRuleAndOperator().WithPrefix(prefix).WithTags(tagSet));
+    } else if (tagSet.size() == 1) {
+        filter.SetTag(tagSet[0]);
+    } else {
+        filter.SetPrefix(prefix);
+    }
+    rule.SetFilter(filter);
+
+    int days;
+    if (expirationDaysPtr) {
+        if (TCL_OK != Tcl_GetIntFromObj(interp, expirationDaysPtr, &days)) {
+            return TCL_ERROR;
+        }
+        rule.SetExpiration(Aws::S3::Model::LifecycleExpiration().WithDays(days));
+    }
+    if (noncurrentDaysPtr) {
+        if (TCL_OK != Tcl_GetIntFromObj(interp, noncurrentDaysPtr, &days)) {
+            return TCL_ERROR;
+        }
+        rule.SetNoncurrentVersionExpiration(Aws::S3::Model::NoncurrentVersionExpiration().WithNoncurrentDays(days));
+    }
+    if (abortDaysPtr) {
+        if (TCL_OK != Tcl_GetIntFromObj(interp, abortDaysPtr, &days)) {
+            return TCL_ERROR;
+        }
+        rule.SetAbortIncompleteMultipartUpload(Aws::S3::Model::AbortIncompleteMultipartUpload().WithDaysAfterInitiation(days));
+    }
+    return TCL_OK;
+}
+
+int aws_sdk_tcl_s3_PutBucketLifecycle(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, Tcl_Obj *rulesListPtr) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+    Aws::S3::S3Client *client = internal->item;
+
+    const Aws::String bucket = bucket_name;
+
+    Tcl_Size listLen;
+    if (TCL_OK != Tcl_ListObjLength(interp, rulesListPtr, &listLen)) {
+        return TCL_ERROR;
+    }
+    Aws::Vector<Aws::S3::Model::LifecycleRule> rules;
+    for (int i = 0; i < listLen; i++) {
+        Tcl_Obj *ruleDictPtr;
+        Tcl_ListObjIndex(interp, rulesListPtr, i, &ruleDictPtr);
+        Aws::S3::Model::LifecycleRule rule;
+        if (TCL_OK != aws_sdk_tcl_s3_GetLifecycleRule(interp, ruleDictPtr, rule)) {
+            return TCL_ERROR;
+        }
+        rules.push_back(rule);
+    }
+
+    Aws::S3::Model::PutBucketLifecycleConfigurationRequest request;
+    request.WithBucket(bucket)
+            .WithLifecycleConfiguration(Aws::S3::Model::BucketLifecycleConfiguration().WithRules(rules));
+
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+    Aws::S3::Model::PutBucketLifecycleConfigurationOutcome outcome =
+            client->PutBucketLifecycleConfiguration(request);
+
+    if (!outcome.IsSuccess()) {
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
+        return TCL_ERROR;
+    } else {
+        return TCL_OK;
+    }
+}
+
+// Splits one CSV record starting at "p" into fields. Inventory files quote
+// every field and escape embedded quotes by doubling them. Returns the
+// start of the next record, or nullptr when the data ends before the
+// record does and more data is to come.
+static const char *
+aws_sdk_tcl_s3_ParseCsvRecord(const char *p, const char *end, int final, Aws::Vector<Aws::String> &fields) {
+    fields.clear();
+    Aws::String field;
+    int quoted = 0;
+    while (p < end) {
+        char c = *p++;
+        if (quoted) {
+            if (c == '"') {
+                if (p < end && *p == '"') {
+                    field.push_back('"');
+                    p++;
+                } else {
+                    quoted = 0;
+                }
+            } else {
+                field.push_back(c);
+            }
+        } else if (c == '"') {
+            quoted = 1;
+        } else if (c == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else if (c == '\n') {
+            fields.push_back(field);
+            return p;
+        } else if (c != '\r') {
+            field.push_back(c);
+        }
+    }
+    if (!final) {
+        return nullptr;
+    }
+    fields.push_back(field);
+    return p;
+}
+
+static int
+aws_sdk_tcl_s3_InvokeInventoryCmd(Tcl_Interp *interp, Tcl_Obj *cmdPtr, Tcl_Obj *batchPtr) {
+    Tcl_Obj *evalPtr = Tcl_DuplicateObj(cmdPtr);
+    Tcl_IncrRefCount(evalPtr);
+    Tcl_ListObjAppendElement(interp, evalPtr, batchPtr);
+    int rc = Tcl_EvalObjEx(interp, evalPtr, TCL_EVAL_GLOBAL);
+    Tcl_DecrRefCount(evalPtr);
+    return rc;
+}
+
+// Reads the data files of an S3 Inventory report. The manifest.json is
+// fetched first, then up to "concurrency" data files are downloaded in
+// parallel while the rows of the completed ones are handed to "cmd", in
+// file order, as lists of at most "batch_size" dicts keyed by the
+// fields of the report schema. The downloaded files are held in memory
+// as they come, compressed, and inflated chunk by chunk while they are
+// read. Returns the number of rows delivered.
+int aws_sdk_tcl_s3_ReadInventory(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *manifest_key, Tcl_Obj *cmdPtr, int batch_size, int concurrency) {
+    DBG(fprintf(stderr, "ReadInventory: handle=%s bucket_name=%s manifest_key=%s\n", Tcl_GetString(handlePtr), bucket_name, manifest_key));
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+    Aws::S3::S3Client *client = internal->item;
+
+    Aws::S3::Model::GetObjectRequest manifestRequest;
+    manifestRequest.SetBucket(bucket_name);
+    manifestRequest.SetKey(manifest_key);
+
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+    Aws::S3::Model::GetObjectOutcome manifestOutcome = client->GetObject(manifestRequest);
+    if (!manifestOutcome.IsSuccess()) {
+        aws_sdk_tcl_SetErrorResult(interp, "S3", manifestOutcome.GetError());
+        return TCL_ERROR;
+    }
+    std::stringstream manifestStream;
+    manifestStream << manifestOutcome.GetResult().GetBody().rdbuf();
+
+    Aws::Utils::Json::JsonValue manifest(manifestStream.str());
+    if (!manifest.WasParseSuccessful()) {
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("invalid inventory manifest: %s", manifest.GetErrorMessage().c_str()));
+        return TCL_ERROR;
+    }
+    Aws::Utils::Json::JsonView manifestView = manifest.View();
+
+    const Aws::String fileFormat = manifestView.GetString("fileFormat");
+    if (fileFormat != "CSV") {
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("unsupported inventory format \"%s\", only CSV is supported", fileFormat.c_str()));
+        return TCL_ERROR;
+    }
+
+    // the data files live in the destination bucket, given as an ARN
+    Aws::String dataBucket = bucket_name;
+    if (manifestView.ValueExists("destinationBucket")) {
+        const Aws::String destination = manifestView.GetString("destinationBucket");
+        size_t pos = destination.rfind(':');
+        dataBucket = pos == Aws::String::npos ? destination : destination.substr(pos + 1);
+    }
+
+    Aws::Vector<Aws::String> fieldNames = Aws::Utils::StringUtils::Split(manifestView.GetString("fileSchema"), ',');
+    Tcl_Obj **fieldNamePtrs = (Tcl_Obj **) Tcl_Alloc(sizeof(Tcl_Obj *) * (fieldNames.size() + 1));
+    int keyIndex = -1;
+    for (size_t i = 0; i < fieldNames.size(); i++) {
+        Aws::String name = Aws::Utils::StringUtils::Trim(fieldNames[i].c_str());
+        if (name == "Key") {
+            keyIndex = (int) i;
+        }
+        fieldNamePtrs[i] = Tcl_NewStringObj(name.c_str(), -1);
+        Tcl_IncrRefCount(fieldNamePtrs[i]);
+    }
+
+    Aws::Vector<Aws::String> dataKeys;
+    Aws::Utils::Array<Aws::Utils::Json::JsonView> files = manifestView.GetArray("files");
+    for (size_t i = 0; i < files.GetLength(); i++) {
+        dataKeys.push_back(files[i].GetString("key"));
+    }
+
+    std::deque<Aws::S3::Model::GetObjectOutcomeCallable> inflight;
+    size_t next = 0;
+    Tcl_WideInt rows = 0;
+    int rc = TCL_OK;
+    int stop = 0;
+    Tcl_Obj *batchPtr = Tcl_NewListObj(0, nullptr);
+    Tcl_IncrRefCount(batchPtr);
+    Aws::Vector<Aws::String> fields;
+
+    for (size_t done = 0; done < dataKeys.size() && !stop; done++) {
+        while (next < dataKeys.size() && inflight.size() < (size_t) concurrency) {
+            Aws::S3::Model::GetObjectRequest request;
+            request.SetBucket(dataBucket);
+            request.SetKey(dataKeys[next]);
+            aws_sdk_tcl_s3_ApplyRequestLimit(internal);
+            inflight.push_back(client->GetObjectCallable(request));
+            next++;
+        }
+
+        Aws::S3::Model::GetObjectOutcome outcome = inflight.front().get();
+        inflight.pop_front();
+        if (!outcome.IsSuccess()) {
+            aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
+            rc = TCL_ERROR;
+            break;
+        }
+        // the body is read and inflated in chunks and the rows are parsed
+        // as they come, only the compressed body is held in memory
+        Aws::IOStream &body = outcome.GetResult().GetBody();
+        const Aws::String &dataKey = dataKeys[done];
+        Tcl_ZlibStream zstream = nullptr;
+        if (dataKey.size() > 3 && dataKey.compare(dataKey.size() - 3, 3, ".gz") == 0
+            && TCL_OK != Tcl_ZlibStreamInit(interp, TCL_ZLIB_STREAM_INFLATE, TCL_ZLIB_FORMAT_GZIP, 0, nullptr, &zstream)) {
+            rc = TCL_ERROR;
+            break;
+        }
+        Aws::String pending;
+        int final = 0;
+        while (!final && !stop) {
+            char chunk[65536];
+            body.read(chunk, sizeof(chunk));
+            auto count = (Tcl_Size) body.gcount();
+            final = !body;
+            if (zstream) {
+                Tcl_Obj *inPtr = Tcl_NewByteArrayObj((const unsigned char *) chunk, count);
+                Tcl_Obj *outPtr = Tcl_NewObj();
+                Tcl_IncrRefCount(inPtr);
+                Tcl_IncrRefCount(outPtr);
+                if (TCL_OK != Tcl_ZlibStreamPut(zstream, inPtr, final ? TCL_ZLIB_FINALIZE : TCL_ZLIB_NO_FLUSH)
+                    || TCL_OK != Tcl_ZlibStreamGet(zstream, outPtr, -1)) {
+                    Tcl_DecrRefCount(inPtr);
+                    Tcl_DecrRefCount(outPtr);
+                    rc = TCL_ERROR;
+                    stop = 1;
+                    break;
+                }
+                Tcl_Size length;
+                const unsigned char *bytes = Tcl_GetByteArrayFromObj(outPtr, &length);
+                pending.append((const char *) bytes, (size_t) length);
+                Tcl_DecrRefCount(inPtr);
+                Tcl_DecrRefCount(outPtr);
+            } else {
+                pending.append(chunk, (size_t) count);
+            }
+
+            const char *start = pending.data();
+            const char *p = start;
+            const char *end = start + pending.size();
+            while (p < end && !stop) {
+                const char *recordEnd = aws_sdk_tcl_s3_ParseCsvRecord(p, end, final, fields);
+                if (recordEnd == nullptr) {
+                    // the rest of the record comes with the next chunk
+                    break;
+                }
+                p = recordEnd;
+                if (fields.size() == 1 && fields[0].empty()) {
+                    continue;
+                }
+                Tcl_Obj *rowPtr = Tcl_NewDictObj();
+                for (size_t i = 0; i < fields.size() && i < fieldNames.size(); i++) {
+                    // object keys are URL-encoded in the report
+                    const Aws::String value = (int) i == keyIndex
+                            ? Aws::Utils::StringUtils::URLDecode(fields[i].c_str())
+                            : fields[i];
+                    Tcl_DictObjPut(interp, rowPtr, fieldNamePtrs[i], Tcl_NewStringObj(value.c_str(), -1));
+                }
+                Tcl_ListObjAppendElement(interp, batchPtr, rowPtr);
+                rows++;
+
+                Tcl_Size batchLength;
+                Tcl_ListObjLength(interp, batchPtr, &batchLength);
+                if (batchLength >= batch_size) {
+                    int cmdRc = aws_sdk_tcl_s3_InvokeInventoryCmd(interp, cmdPtr, batchPtr);
+                    Tcl_DecrRefCount(batchPtr);
+                    batchPtr = Tcl_NewListObj(0, nullptr);
+                    Tcl_IncrRefCount(batchPtr);
+                    if (cmdRc == TCL_BREAK) {
+                        stop = 1;
+                    } else if (cmdRc == TCL_ERROR || cmdRc == TCL_RETURN) {
+                        rc = cmdRc;
+                        stop = 1;
+                    }
+                }
+            }
+            pending.erase(0, (size_t) (p - start));
+        }
+        if (zstream) {
+            Tcl_ZlibStreamClose(zstream);
+        }
+        if (rc != TCL_OK) {
+            break;
+        }
+    }
+
+    if (rc == TCL_OK && !stop) {
+        Tcl_Size batchLength;
+        Tcl_ListObjLength(interp, batchPtr, &batchLength);
+        if (batchLength > 0) {
+            int cmdRc = aws_sdk_tcl_s3_InvokeInventoryCmd(interp, cmdPtr, batchPtr);
+            if (cmdRc == TCL_ERROR || cmdRc == TCL_RETURN) {
+                rc = cmdRc;
+            }
+        }
+    }
+    Tcl_DecrRefCount(batchPtr);
+
+    // the requests still in flight reference the client, wait for them
+    while (!inflight.empty()) {
+        inflight.front().wait();
+        inflight.pop_front();
+    }
+
+    for (size_t i = 0; i < fieldNames.size(); i++) {
+        Tcl_DecrRefCount(fieldNamePtrs[i]);
+    }
+    Tcl_Free((char *) fieldNamePtrs);
+
+    if (rc == TCL_OK) {
+        Tcl_SetObjResult(interp, Tcl_NewWideIntObj(rows));
+    }
+    return rc;
+}
+
+int aws_sdk_tcl_s3_Exists(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name, const char *key_name) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
     const Aws::String key = key_name;
@@ -430,6 +1538,7 @@ int aws_sdk_tcl_s3_Exists(Tcl_Interp *interp, const char *handle, const char *bu
     request.WithKey(key)
             .WithBucket(bucket);
 
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     Aws::S3::Model::HeadObjectOutcome outcome =
             client->HeadObject(request);
 
@@ -437,64 +1546,70 @@ int aws_sdk_tcl_s3_Exists(Tcl_Interp *interp, const char *handle, const char *bu
     return TCL_OK;
 }
 
-int aws_sdk_tcl_s3_CreateBucket(Tcl_Interp *interp, const char *handle, const char *bucket_name) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_CreateBucket(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
 
     Aws::S3::Model::CreateBucketRequest request;
     request.WithBucket(bucket);
 
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     Aws::S3::Model::CreateBucketOutcome outcome =
             client->CreateBucket(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
         return TCL_ERROR;
     } else {
         return TCL_OK;
     }
 }
 
-int aws_sdk_tcl_s3_DeleteBucket(Tcl_Interp *interp, const char *handle, const char *bucket_name) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_DeleteBucket(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
 
     Aws::S3::Model::DeleteBucketRequest request;
     request.WithBucket(bucket);
 
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     Aws::S3::Model::DeleteBucketOutcome outcome =
             client->DeleteBucket(request);
 
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
         return TCL_ERROR;
     } else {
         return TCL_OK;
     }
 }
 
-int aws_sdk_tcl_s3_ExistsBucket(Tcl_Interp *interp, const char *handle, const char *bucket_name) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_ExistsBucket(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *bucket_name) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
 
     const Aws::String bucket = bucket_name;
 
     Aws::S3::Model::HeadBucketRequest request;
     request.WithBucket(bucket);
 
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     Aws::S3::Model::HeadBucketOutcome outcome =
             client->HeadBucket(request);
 
@@ -502,15 +1617,17 @@ int aws_sdk_tcl_s3_ExistsBucket(Tcl_Interp *interp, const char *handle, const ch
     return TCL_OK;
 }
 
-int aws_sdk_tcl_s3_ListBuckets(Tcl_Interp *interp, const char *handle) {
-    Aws::S3::S3Client *client = aws_sdk_tcl_s3_GetInternalFromName(handle);
-    if (!client) {
+int aws_sdk_tcl_s3_ListBuckets(Tcl_Interp *interp, Tcl_Obj *handlePtr) {
+    aws_sdk_tcl_s3_client_t *internal = aws_sdk_tcl_s3_GetInternalFromObj(handlePtr);
+    if (!internal) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
+    Aws::S3::S3Client *client = internal->item;
+    aws_sdk_tcl_s3_ApplyRequestLimit(internal);
     auto outcome = client->ListBuckets();
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "S3", outcome.GetError());
         return TCL_ERROR;
     }
     else {
@@ -569,6 +1686,10 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
             "exists_bucket",
             "list_buckets",
             "generate_presigned_url",
+            "put_tags",
+            "put_tags_many",
+            "put_bucket_lifecycle",
+            "read_inventory",
             nullptr
     };
 
@@ -585,7 +1706,11 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
         m_deleteBucket,
         m_existsBucket,
         m_listBuckets,
-        m_generatePresignedUrl
+        m_generatePresignedUrl,
+        m_putTags,
+        m_putTagsMany,
+        m_putBucketLifecycle,
+        m_readInventory
     };
 
     if (objc < 2) {
@@ -599,6 +1724,8 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
     if (TCL_OK == Tcl_GetIndexFromObj(interp, objv[1], clientMethods, "method", 0, &methodIndex)) {
         Tcl_ResetResult(interp);
         const char *handle = Tcl_GetString(objv[0]);
+        aws_sdk_tcl_HandleObj handleObj(clientData);
+        Tcl_Obj *handlePtr = handleObj.objPtr;
         switch ((enum clientMethod) methodIndex ) {
             case m_destroy:
                 DBG(fprintf(stderr, "DestroyMethod\n"));
@@ -609,46 +1736,74 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 CheckArgs(3,4,1,"ls bucket ?prefix?");
                 return aws_sdk_tcl_s3_List(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objc == 4 ? Tcl_GetString(objv[3]) : nullptr
                 );
-            case m_putText:
+            case m_putText: {
                 DBG(fprintf(stderr, "PutTextMethod\n"));
-                CheckArgs(5,5,1,"put_text bucket prefix text");
+                if (objc < 5) {
+                    Tcl_WrongNumArgs(interp, 1, objv, "put_text bucket prefix text ?-option value ...?");
+                    return TCL_ERROR;
+                }
+                aws_sdk_tcl_s3_transfer_options_t opts;
+                if (TCL_OK != aws_sdk_tcl_s3_GetTransferOptions(interp, objc - 5, &objv[5], &opts)) {
+                    return TCL_ERROR;
+                }
                 return aws_sdk_tcl_s3_PutText(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
-                        Tcl_GetString(objv[4])
+                        Tcl_GetString(objv[4]),
+                        &opts
                 );
-            case m_put:
+            }
+            case m_put: {
                 DBG(fprintf(stderr, "PutMethod\n"));
-                CheckArgs(5,5,1,"put bucket prefix filename");
+                if (objc < 5) {
+                    Tcl_WrongNumArgs(interp, 1, objv, "put bucket prefix filename ?-option value ...?");
+                    return TCL_ERROR;
+                }
+                aws_sdk_tcl_s3_transfer_options_t opts;
+                if (TCL_OK != aws_sdk_tcl_s3_GetTransferOptions(interp, objc - 5, &objv[5], &opts)) {
+                    return TCL_ERROR;
+                }
                 return aws_sdk_tcl_s3_PutChannel(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
-                        Tcl_GetString(objv[4])
+                        Tcl_GetString(objv[4]),
+                        &opts
                 );
-            case m_get:
+            }
+            case m_get: {
                 DBG(fprintf(stderr, "GetMethod\n"));
-                CheckArgs(4,5,1,"get bucket prefix ?filename?");
+                if (objc < 4) {
+                    Tcl_WrongNumArgs(interp, 1, objv, "get bucket prefix ?filename? ?-option value ...?");
+                    return TCL_ERROR;
+                }
+                int has_filename = objc > 4 && !aws_sdk_tcl_s3_IsTransferOption(objv[4]);
+                aws_sdk_tcl_s3_transfer_options_t opts;
+                if (TCL_OK != aws_sdk_tcl_s3_GetTransferOptions(interp, objc - 4 - has_filename, &objv[4 + has_filename], &opts)) {
+                    return TCL_ERROR;
+                }
                 return aws_sdk_tcl_s3_Get(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
-                        objc == 5 ? Tcl_GetString(objv[4]) : nullptr
+                        has_filename ? Tcl_GetString(objv[4]) : nullptr,
+                        &opts
                 );
+            }
             case m_delete:
                 DBG(fprintf(stderr, "DeleteMethod\n"));
                 CheckArgs(4,4,1,"delete bucket key");
                 return aws_sdk_tcl_s3_Delete(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3])
                 );
@@ -657,7 +1812,7 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 CheckArgs(4,4,1,"batch_delete bucket keys");
                 return aws_sdk_tcl_s3_BatchDelete(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objv[3]
                 );
@@ -666,7 +1821,7 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 CheckArgs(4,4,1,"exists bucket key");
                 return aws_sdk_tcl_s3_Exists(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3])
                 );
@@ -675,7 +1830,7 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 CheckArgs(3,3,1,"create_bucket bucket");
                 return aws_sdk_tcl_s3_CreateBucket(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_deleteBucket:
@@ -683,7 +1838,7 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 CheckArgs(3,3,1,"delete_bucket bucket");
                 return aws_sdk_tcl_s3_DeleteBucket(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_existsBucket:
@@ -691,7 +1846,7 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 CheckArgs(3,3,1,"exists_bucket bucket");
                 return aws_sdk_tcl_s3_ExistsBucket(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_listBuckets:
@@ -699,7 +1854,7 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 CheckArgs(2,2,1,"list_buckets");
                 return aws_sdk_tcl_s3_ListBuckets(
                         interp,
-                        handle
+                        handlePtr
                 );
             case m_generatePresignedUrl:
                 DBG(fprintf(stderr, "GeneratePresignedUrlMethod\n"));
@@ -714,12 +1869,69 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
                 }
                 return aws_sdk_tcl_s3_GeneratePresignedUrl(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
                         (aws_sdk_tcl_http_method) http_method,
                         expiration_seconds
                 );
+            case m_putTags:
+                DBG(fprintf(stderr, "PutTagsMethod\n"));
+                CheckArgs(5,5,1,"put_tags bucket key tags_dict");
+                return aws_sdk_tcl_s3_PutTags(
+                        interp,
+                        handlePtr,
+                        Tcl_GetString(objv[2]),
+                        Tcl_GetString(objv[3]),
+                        objv[4]
+                );
+            case m_putTagsMany: {
+                DBG(fprintf(stderr, "PutTagsManyMethod\n"));
+                CheckArgs(4,5,1,"put_tags_many bucket key_tags_dict ?concurrency?");
+                int concurrency = 16;
+                if (objc == 5 && TCL_OK != Tcl_GetIntFromObj(interp, objv[4], &concurrency)) {
+                    return TCL_ERROR;
+                }
+                if (concurrency < 1) {
+                    concurrency = 1;
+                }
+                return aws_sdk_tcl_s3_PutTagsMany(
+                        interp,
+                        handlePtr,
+                        Tcl_GetString(objv[2]),
+                        objv[3],
+                        concurrency
+                );
+            }
+            case m_putBucketLifecycle:
+                DBG(fprintf(stderr, "PutBucketLifecycleMethod\n"));
+                CheckArgs(4,4,1,"put_bucket_lifecycle bucket rules");
+                return aws_sdk_tcl_s3_PutBucketLifecycle(
+                        interp,
+                        handlePtr,
+                        Tcl_GetString(objv[2]),
+                        objv[3]
+                );
+            case m_readInventory: {
+                DBG(fprintf(stderr, "ReadInventoryMethod\n"));
+                if (objc < 5 || (objc - 5) % 2) {
+                    Tcl_WrongNumArgs(interp, 1, objv, "read_inventory bucket manifest_key cmd ?-option value ...?");
+                    return TCL_ERROR;
+                }
+                int batch_size, concurrency;
+                if (TCL_OK != aws_sdk_tcl_s3_GetInventoryOptions(interp, objc - 5, &objv[5], &batch_size, &concurrency)) {
+                    return TCL_ERROR;
+                }
+                return aws_sdk_tcl_s3_ReadInventory(
+                        interp,
+                        handlePtr,
+                        Tcl_GetString(objv[2]),
+                        Tcl_GetString(objv[3]),
+                        objv[4],
+                        batch_size,
+                        concurrency
+                );
+            }
         }
     }
 
@@ -730,35 +1942,124 @@ int aws_sdk_tcl_s3_ClientObjCmd(ClientData  clientData, Tcl_Interp *interp, int
 static int aws_sdk_tcl_s3_CreateCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[]) {
     DBG(fprintf(stderr, "CreateCmd\n"));
 
-    CheckArgs(2,3,1,"config_dict ?varname?");
+    static const char *const options[] = { "-max-bandwidth", "-requests-per-second", "-shared", NULL };
+    enum options { OPT_MAX_BANDWIDTH, OPT_REQUESTS_PER_SECOND, OPT_SHARED };
 
-    auto result = get_client_config_and_credentials_provider(interp, objv[1]);
-    int status = std::get<0>(result);
-    if (TCL_OK != status) {
-        SetResult("Invalid config_dict");
+    Tcl_WideInt max_bandwidth = 0;
+    Tcl_WideInt requests_per_second = 0;
+    int shared = 0;
+
+    int i;
+    for (i = 1; i < objc; i++) {
+        const char *arg = Tcl_GetString(objv[i]);
+        if (arg[0] != '-') {
+            break;
+        }
+        int option;
+        if (Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &option) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (option == OPT_SHARED) {
+            shared = 1;
+            continue;
+        }
+        if (++i == objc) {
+            Tcl_WrongNumArgs(interp, 1, objv, "?-shared? ?-max-bandwidth bytes_per_second? ?-requests-per-second count? config_dict ?varname?");
+            return TCL_ERROR;
+        }
+        Tcl_WideInt value;
+        if (Tcl_GetWideIntFromObj(interp, objv[i], &value) != TCL_OK) {
+            return TCL_ERROR;
+        }
+        if (value < 0) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("unsigned integer >= 0 is expected,"
+                " but got \"%s\"", Tcl_GetString(objv[i])));
+            return TCL_ERROR;
+        }
+        switch ((enum options) option) {
+        case OPT_MAX_BANDWIDTH:
+            max_bandwidth = value;
+            break;
+        case OPT_REQUESTS_PER_SECOND:
+            requests_per_second = value;
+            break;
+        case OPT_SHARED:
+            break;
+        }
+    }
+
+    if ((objc - i) < 1 || (objc - i) > 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?-shared? ?-max-bandwidth bytes_per_second? ?-requests-per-second count? config_dict ?varname?");
         return TCL_ERROR;
     }
-    Aws::Client::ClientConfiguration client_config = std::get<1>(result);
-    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+    Tcl_Obj *configDictPtr = objv[i];
+    Tcl_Obj *varNamePtr = (objc - i) == 2 ? objv[i + 1] : nullptr;
+
+    Aws::String key;
+    aws_sdk_tcl_s3_client_t *internal = nullptr;
+    if (shared) {
+        // the limits belong to the pooled client, so they are part of its key
+        if (TCL_OK != aws_sdk_tcl_GetSharedClientKey(interp, "s3", configDictPtr, key)) {
+            return TCL_ERROR;
+        }
+        key.append("\n-max-bandwidth ").append(std::to_string(max_bandwidth).c_str());
+        key.append("\n-requests-per-second ").append(std::to_string(requests_per_second).c_str());
+        // the configuration and credentials are only set up for a new client
+        internal = (aws_sdk_tcl_s3_client_t *) aws_sdk_tcl_FindSharedClient(key);
+    }
+    if (!internal) {
+        auto result = get_client_config_and_credentials_provider(interp, configDictPtr);
+        int status = std::get<0>(result);
+        if (TCL_OK != status) {
+            return TCL_ERROR;
+        }
+        Aws::Client::ClientConfiguration client_config = std::get<1>(result);
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+
+        if (max_bandwidth > 0) {
+            // the same bucket throttles both directions, so that the total
+            // traffic of the handle never exceeds the given bandwidth
+            auto bandwidth_limiter = Aws::MakeShared<Aws::Utils::RateLimits::DefaultRateLimiter<>>(
+                    Aws::S3::S3Client::ALLOCATION_TAG, (int64_t) max_bandwidth);
+            client_config.readRateLimiter = bandwidth_limiter;
+            client_config.writeRateLimiter = bandwidth_limiter;
+        }
 
-    auto *client = credentials_provider_ptr != nullptr ? new Aws::S3::S3Client(credentials_provider_ptr, Aws::MakeShared<Aws::S3::S3EndpointProvider>(Aws::S3::S3Client::ALLOCATION_TAG), client_config) : new Aws::S3::S3Client(client_config);
+        internal = new aws_sdk_tcl_s3_client_t;
+        internal->progress_ops = 0;
+        internal->config = client_config;
+        internal->credentials_provider = credentials_provider_ptr;
+        internal->item = aws_sdk_tcl_s3_NewClient(credentials_provider_ptr, client_config);
+        if (requests_per_second > 0) {
+            internal->request_limiter = Aws::MakeShared<Aws::Utils::RateLimits::DefaultRateLimiter<>>(
+                    Aws::S3::S3Client::ALLOCATION_TAG, (int64_t) requests_per_second);
+        }
+        if (shared) {
+            internal = (aws_sdk_tcl_s3_client_t *) aws_sdk_tcl_AddSharedClient(key, internal, aws_sdk_tcl_s3_DeleteClient);
+        }
+    }
+    auto *client = internal->item;
     char handle[80];
-    CMD_NAME(handle, client);
-    aws_sdk_tcl_s3_RegisterName(handle, client);
+    if (shared) {
+        SHARED_CMD_NAME(handle, client, aws_sdk_tcl_NewSharedHandleId());
+    } else {
+        CMD_NAME(handle, client);
+    }
+    ClientData handleRef = aws_sdk_tcl_s3_RegisterName(handle, internal);
 
     Tcl_CreateObjCommand(interp, handle,
                                  (Tcl_ObjCmdProc *)  aws_sdk_tcl_s3_ClientObjCmd,
-                                 nullptr,
-                                 nullptr);
+                                 handleRef,
+                                 (Tcl_CmdDeleteProc *) aws_sdk_tcl_FreeHandleRef);
 //                                 (Tcl_CmdDeleteProc*) aws_sdk_tcl_s3_clientObjCmdDeleteProc);
 
-    if (objc == 3) {
+    if (varNamePtr) {
         auto *trace = (aws_sdk_tcl_s3_trace_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_s3_trace_t));
         trace->interp = interp;
-        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2]), 80);
+        trace->varname = aws_sdk_strndup(Tcl_GetString(varNamePtr), 80);
         trace->handle = aws_sdk_strndup(handle, 80);
         trace->item = client;
-        const char *objVar = Tcl_GetString(objv[2]);
+        const char *objVar = Tcl_GetString(varNamePtr);
         Tcl_UnsetVar(interp, objVar, 0);
         Tcl_SetVar  (interp, objVar, handle, 0);
         Tcl_TraceVar(interp,objVar,TCL_TRACE_WRITES|TCL_TRACE_UNSETS,
@@ -779,68 +2080,90 @@ static int aws_sdk_tcl_s3_DestroyCmd(ClientData  clientData, Tcl_Interp *interp,
 static int aws_sdk_tcl_s3_ListCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr,"ListCmd\n"));
     CheckArgs(3,4,1,"handle_name bucket ?key?");
-    return aws_sdk_tcl_s3_List(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), objc == 4 ? Tcl_GetString(objv[3]) : nullptr);
+    return aws_sdk_tcl_s3_List(interp, objv[1], Tcl_GetString(objv[2]), objc == 4 ? Tcl_GetString(objv[3]) : nullptr);
 }
 
 static int aws_sdk_tcl_s3_PutTextCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "PutCmd\n"));
-    CheckArgs(5,5,1,"handle_name bucket key text");
-    return aws_sdk_tcl_s3_PutText(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), Tcl_GetString(objv[4]));
+    if (objc < 5) {
+        Tcl_WrongNumArgs(interp, 1, objv, "handle_name bucket key text ?-option value ...?");
+        return TCL_ERROR;
+    }
+    aws_sdk_tcl_s3_transfer_options_t opts;
+    if (TCL_OK != aws_sdk_tcl_s3_GetTransferOptions(interp, objc - 5, &objv[5], &opts)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_s3_PutText(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), Tcl_GetString(objv[4]), &opts);
 }
 
 
 static int aws_sdk_tcl_s3_PutChannelCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "PutChannelCmd\n"));
-    CheckArgs(5,5,1,"handle_name bucket key filename");
-    return aws_sdk_tcl_s3_PutChannel(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), Tcl_GetString(objv[4]));
+    if (objc < 5) {
+        Tcl_WrongNumArgs(interp, 1, objv, "handle_name bucket key filename ?-option value ...?");
+        return TCL_ERROR;
+    }
+    aws_sdk_tcl_s3_transfer_options_t opts;
+    if (TCL_OK != aws_sdk_tcl_s3_GetTransferOptions(interp, objc - 5, &objv[5], &opts)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_s3_PutChannel(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), Tcl_GetString(objv[4]), &opts);
 }
 
 static int aws_sdk_tcl_s3_GetCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "GetCmd\n"));
-    CheckArgs(4,5,1,"handle_name bucket key ?filename?");
-    return aws_sdk_tcl_s3_Get(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), objc == 5 ? Tcl_GetString(objv[4]) : nullptr);
+    if (objc < 4) {
+        Tcl_WrongNumArgs(interp, 1, objv, "handle_name bucket key ?filename? ?-option value ...?");
+        return TCL_ERROR;
+    }
+    int has_filename = objc > 4 && !aws_sdk_tcl_s3_IsTransferOption(objv[4]);
+    aws_sdk_tcl_s3_transfer_options_t opts;
+    if (TCL_OK != aws_sdk_tcl_s3_GetTransferOptions(interp, objc - 4 - has_filename, &objv[4 + has_filename], &opts)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_s3_Get(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), has_filename ? Tcl_GetString(objv[4]) : nullptr, &opts);
 }
 
 static int aws_sdk_tcl_s3_DeleteCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "DeleteCmd\n"));
     CheckArgs(4,4,1,"handle_name bucket key");
-    return aws_sdk_tcl_s3_Delete(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
+    return aws_sdk_tcl_s3_Delete(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
 }
 
 static int aws_sdk_tcl_s3_BatchDeleteCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "BatchDeleteCmd\n"));
     CheckArgs(4,4,1,"handle_name bucket keys");
-    return aws_sdk_tcl_s3_BatchDelete(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), objv[3]);
+    return aws_sdk_tcl_s3_BatchDelete(interp, objv[1], Tcl_GetString(objv[2]), objv[3]);
 }
 
 static int aws_sdk_tcl_s3_ExistsCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "ExistsCmd\n"));
     CheckArgs(4,4,1,"handle_name bucket key");
-    return aws_sdk_tcl_s3_Exists(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
+    return aws_sdk_tcl_s3_Exists(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]));
 }
 
 static int aws_sdk_tcl_s3_CreateBucketCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "CreateBucketCmd\n"));
     CheckArgs(3,3,1,"handle_name bucket");
-    return aws_sdk_tcl_s3_CreateBucket(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_s3_CreateBucket(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_s3_DeleteBucketCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "DeleteBucketCmd\n"));
     CheckArgs(3,3,1,"handle_name bucket");
-    return aws_sdk_tcl_s3_DeleteBucket(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_s3_DeleteBucket(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_s3_ExistsBucketCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "ExistsBucketCmd\n"));
     CheckArgs(3,3,1,"handle_name bucket");
-    return aws_sdk_tcl_s3_ExistsBucket(interp, Tcl_GetString(objv[1]), Tcl_GetString(objv[2]));
+    return aws_sdk_tcl_s3_ExistsBucket(interp, objv[1], Tcl_GetString(objv[2]));
 }
 
 static int aws_sdk_tcl_s3_ListBucketsCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
     DBG(fprintf(stderr, "ListBucketsCmd\n"));
     CheckArgs(2,2,1,"handle_name");
-    return aws_sdk_tcl_s3_ListBuckets(interp, Tcl_GetString(objv[1]));
+    return aws_sdk_tcl_s3_ListBuckets(interp, objv[1]);
 }
 
 static int aws_sdk_tcl_s3_GeneratePresignedUrlCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
@@ -885,19 +2208,96 @@ numArgsError:
         }
     }
 
-    return aws_sdk_tcl_s3_GeneratePresignedUrl(interp, Tcl_GetString(objv[objc - 3]),
+    return aws_sdk_tcl_s3_GeneratePresignedUrl(interp, objv[objc - 3],
         Tcl_GetString(objv[objc - 2]), Tcl_GetString(objv[objc - 1]),
         (aws_sdk_tcl_http_method)http_method, expiration_seconds);
 
 }
 
-static Aws::SDKOptions options;
+static int aws_sdk_tcl_s3_PutTagsCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
+    DBG(fprintf(stderr, "PutTagsCmd\n"));
+    CheckArgs(5,5,1,"handle_name bucket key tags_dict");
+    return aws_sdk_tcl_s3_PutTags(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), objv[4]);
+}
+
+static int aws_sdk_tcl_s3_PutTagsManyCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
+    DBG(fprintf(stderr, "PutTagsManyCmd\n"));
+    CheckArgs(4,5,1,"handle_name bucket key_tags_dict ?concurrency?");
+    int concurrency = 16;
+    if (objc == 5 && TCL_OK != Tcl_GetIntFromObj(interp, objv[4], &concurrency)) {
+        return TCL_ERROR;
+    }
+    if (concurrency < 1) {
+        concurrency = 1;
+    }
+    return aws_sdk_tcl_s3_PutTagsMany(interp, objv[1], Tcl_GetString(objv[2]), objv[3], concurrency);
+}
+
+static int aws_sdk_tcl_s3_PutBucketLifecycleCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
+    DBG(fprintf(stderr, "PutBucketLifecycleCmd\n"));
+    CheckArgs(4,4,1,"handle_name bucket rules");
+    return aws_sdk_tcl_s3_PutBucketLifecycle(interp, objv[1], Tcl_GetString(objv[2]), objv[3]);
+}
+
+static int aws_sdk_tcl_s3_ReadInventoryCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
+    DBG(fprintf(stderr, "ReadInventoryCmd\n"));
+    if (objc < 5 || (objc - 5) % 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "handle_name bucket manifest_key cmd ?-option value ...?");
+        return TCL_ERROR;
+    }
+    int batch_size, concurrency;
+    if (TCL_OK != aws_sdk_tcl_s3_GetInventoryOptions(interp, objc - 5, &objv[5], &batch_size, &concurrency)) {
+        return TCL_ERROR;
+    }
+    return aws_sdk_tcl_s3_ReadInventory(interp, objv[1], Tcl_GetString(objv[2]), Tcl_GetString(objv[3]), objv[4], batch_size, concurrency);
+}
+
+static int aws_sdk_tcl_s3_CreateTokenCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
+    DBG(fprintf(stderr, "CreateTokenCmd\n"));
+    CheckArgs(1,1,1,"");
+    char name[80];
+    aws_sdk_tcl_s3_CreateToken(name);
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(name, -1));
+    return TCL_OK;
+}
+
+static int aws_sdk_tcl_s3_CancelCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
+    DBG(fprintf(stderr, "CancelCmd\n"));
+    CheckArgs(2,2,1,"token");
+    if (!aws_sdk_tcl_s3_CancelToken(Tcl_GetString(objv[1]))) {
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("token not found: %s", Tcl_GetString(objv[1])));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+static int aws_sdk_tcl_s3_ReleaseTokenCmd(ClientData  clientData, Tcl_Interp *interp, int objc, Tcl_Obj * const objv[] ) {
+    DBG(fprintf(stderr, "ReleaseTokenCmd\n"));
+    CheckArgs(2,2,1,"token");
+    if (!aws_sdk_tcl_s3_DeleteToken(Tcl_GetString(objv[1]))) {
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("token not found: %s", Tcl_GetString(objv[1])));
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
 
 static void aws_sdk_tcl_s3_ExitHandler(ClientData unused)
 {
     Tcl_MutexLock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
     Tcl_DeleteHashTable(&aws_sdk_tcl_s3_NameToInternal_HT);
-    Aws::ShutdownAPI(options);
+    Tcl_MutexLock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+    Tcl_HashSearch search;
+    for (Tcl_HashEntry *entryPtr = Tcl_FirstHashEntry(&aws_sdk_tcl_s3_Tokens_HT, &search);
+         entryPtr != nullptr; entryPtr = Tcl_NextHashEntry(&search)) {
+        auto *token = (aws_sdk_tcl_s3_token_t *) Tcl_GetHashValue(entryPtr);
+        if (--token->refCount == 0) {
+            delete token;
+        }
+    }
+    Tcl_DeleteHashTable(&aws_sdk_tcl_s3_Tokens_HT);
+    Tcl_MutexUnlock(&aws_sdk_tcl_s3_Tokens_HT_Mutex);
+    aws_sdk_tcl_ShutdownAPI();
+    aws_sdk_tcl_s3_ModuleInitialized = 0;
     Tcl_MutexUnlock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
 
 }
@@ -906,8 +2306,9 @@ static void aws_sdk_tcl_s3_ExitHandler(ClientData unused)
 void aws_sdk_tcl_s3_InitModule() {
     Tcl_MutexLock(&aws_sdk_tcl_s3_NameToInternal_HT_Mutex);
     if (!aws_sdk_tcl_s3_ModuleInitialized) {
-        Aws::InitAPI(options);
+        aws_sdk_tcl_InitAPI();
         Tcl_InitHashTable(&aws_sdk_tcl_s3_NameToInternal_HT, TCL_STRING_KEYS);
+        Tcl_InitHashTable(&aws_sdk_tcl_s3_Tokens_HT, TCL_STRING_KEYS);
         Tcl_CreateThreadExitHandler(aws_sdk_tcl_s3_ExitHandler, nullptr);
         aws_sdk_tcl_s3_ModuleInitialized = 1;
     }
@@ -930,6 +2331,7 @@ int Aws_sdk_tcl_s3_Init(Tcl_Interp *interp) {
     aws_sdk_tcl_s3_InitModule();
 
     Tcl_CreateNamespace(interp, "::aws::s3", nullptr, nullptr);
+    aws_sdk_tcl_CreateCommonCmds(interp);
     Tcl_CreateObjCommand(interp, "::aws::s3::create", aws_sdk_tcl_s3_CreateCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::s3::destroy", aws_sdk_tcl_s3_DestroyCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::s3::ls", aws_sdk_tcl_s3_ListCmd, nullptr, nullptr);
@@ -944,6 +2346,13 @@ int Aws_sdk_tcl_s3_Init(Tcl_Interp *interp) {
     Tcl_CreateObjCommand(interp, "::aws::s3::exists_bucket", aws_sdk_tcl_s3_ExistsBucketCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::s3::list_buckets", aws_sdk_tcl_s3_ListBucketsCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::s3::generate_presigned_url", aws_sdk_tcl_s3_GeneratePresignedUrlCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::s3::create_token", aws_sdk_tcl_s3_CreateTokenCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::s3::cancel", aws_sdk_tcl_s3_CancelCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::s3::release_token", aws_sdk_tcl_s3_ReleaseTokenCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::s3::put_tags", aws_sdk_tcl_s3_PutTagsCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::s3::put_tags_many", aws_sdk_tcl_s3_PutTagsManyCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::s3::put_bucket_lifecycle", aws_sdk_tcl_s3_PutBucketLifecycleCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::s3::read_inventory", aws_sdk_tcl_s3_ReadInventoryCmd, nullptr, nullptr);
 
     return Tcl_PkgProvide(interp, "awss3", XSTR(VERSION));
 }
@@ -47,6 +47,7 @@ typedef int Tcl_Size;
                  }
 
 #define CMD_NAME(s, internal) std::sprintf((s), "_AWS_S3_%p", (internal))
+#define SHARED_CMD_NAME(s, internal, id) std::sprintf((s), "_AWS_S3_%p_%lu", (internal), (id))
 
 static char VAR_READ_ONLY_MSG[] = "var is read-only";
 
@@ -76,7 +77,7 @@ static char client_usage[] =
         "  get_queue_attributes queue_url\n";
 
 
-static int
+static ClientData
 aws_sdk_tcl_sqs_RegisterName(const char *name, Aws::SQS::SQSClient *internal) {
 
     Tcl_HashEntry *entryPtr;
@@ -85,14 +86,16 @@ aws_sdk_tcl_sqs_RegisterName(const char *name, Aws::SQS::SQSClient *internal) {
     Tcl_MutexLock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
     entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_sqs_NameToInternal_HT, (char *) name, &newEntry);
     if (newEntry) {
-        Tcl_SetHashValue(entryPtr, (ClientData) internal);
+        Tcl_SetHashValue(entryPtr, (ClientData) aws_sdk_tcl_AllocSlot(&aws_sdk_tcl_sqs_NameToInternal_HT, internal));
     }
+    // becomes the clientData of the handle command
+    ClientData handleRef = aws_sdk_tcl_NewHandleRef((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr), name);
     Tcl_MutexUnlock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
 
     DBG(fprintf(stderr, "--> RegisterName: name=%s internal=%p %s\n", name, internal,
                 newEntry ? "entered into" : "already in"));
 
-    return !!newEntry;
+    return handleRef;
 }
 
 static int
@@ -103,6 +106,7 @@ aws_sdk_tcl_sqs_UnregisterName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_sqs_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
+        aws_sdk_tcl_FreeSlot((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
         Tcl_DeleteHashEntry(entryPtr);
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
@@ -120,27 +124,57 @@ aws_sdk_tcl_sqs_GetInternalFromName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_sqs_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
-        internal = (Aws::SQS::SQSClient *) Tcl_GetHashValue(entryPtr);
+        internal = (Aws::SQS::SQSClient *) aws_sdk_tcl_GetSlotItem((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
 
     return internal;
 }
 
+static Aws::SQS::SQSClient *
+aws_sdk_tcl_sqs_GetInternalFromObj(Tcl_Obj *objPtr) {
+    // no locking once the object caches the slot of the handle
+    auto *internal = (Aws::SQS::SQSClient *) aws_sdk_tcl_GetCachedItem(objPtr, &aws_sdk_tcl_sqs_NameToInternal_HT);
+    if (internal == nullptr) {
+        Tcl_HashEntry *entryPtr;
+
+        Tcl_MutexLock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
+        entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_sqs_NameToInternal_HT, Tcl_GetString(objPtr));
+        if (entryPtr != nullptr) {
+            internal = (Aws::SQS::SQSClient *) aws_sdk_tcl_SetCachedItem(objPtr, (aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
+        }
+        Tcl_MutexUnlock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
+    }
+
+    return internal;
+}
+
+static void
+aws_sdk_tcl_sqs_DeleteClient(void *client) {
+    delete (Aws::SQS::SQSClient *) client;
+}
+
 int aws_sdk_tcl_sqs_Destroy(Tcl_Interp *interp, const char *handle) {
     Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
     if (!aws_sdk_tcl_sqs_UnregisterName(handle)) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
-    delete client;
+    // a shared client is only destroyed with its last handle
+    if (aws_sdk_tcl_ReleaseSharedClient(client)) {
+        aws_sdk_tcl_sqs_DeleteClient(client);
+    }
     Tcl_DeleteCommand(interp, handle);
     Tcl_SetObjResult(interp, Tcl_NewStringObj(handle, -1));
     return TCL_OK;
 }
 
-int aws_sdk_tcl_sqs_CreateQueue(Tcl_Interp *interp, const char *handle, const char *queue_name) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+int aws_sdk_tcl_sqs_CreateQueue(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *queue_name) {
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -153,13 +187,13 @@ int aws_sdk_tcl_sqs_CreateQueue(Tcl_Interp *interp, const char *handle, const ch
         Tcl_SetObjResult(interp, Tcl_NewStringObj(queueUrl.c_str(), -1));
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
-int aws_sdk_tcl_sqs_DeleteQueue(Tcl_Interp *interp, const char *handle, const char *queue_url) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+int aws_sdk_tcl_sqs_DeleteQueue(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *queue_url) {
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -171,13 +205,13 @@ int aws_sdk_tcl_sqs_DeleteQueue(Tcl_Interp *interp, const char *handle, const ch
         Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
-int aws_sdk_tcl_sqs_ListQueues(Tcl_Interp *interp, const char *handle) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+int aws_sdk_tcl_sqs_ListQueues(Tcl_Interp *interp, Tcl_Obj *handlePtr) {
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -194,13 +228,13 @@ int aws_sdk_tcl_sqs_ListQueues(Tcl_Interp *interp, const char *handle) {
         Tcl_SetObjResult(interp, listPtr);
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
-int aws_sdk_tcl_sqs_SendMessage(Tcl_Interp *interp, const char *handle, const char *queue_url, const char *message) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+int aws_sdk_tcl_sqs_SendMessage(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *queue_url, const char *message) {
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -213,14 +247,14 @@ int aws_sdk_tcl_sqs_SendMessage(Tcl_Interp *interp, const char *handle, const ch
         Tcl_SetObjResult(interp, Tcl_NewBooleanObj(1));
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
-int aws_sdk_tcl_sqs_ReceiveMessages(Tcl_Interp *interp, const char *handle, const char *queue_url,
+int aws_sdk_tcl_sqs_ReceiveMessages(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *queue_url,
                                     Tcl_Obj *const maxNumberOfMessagesPtr) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -254,15 +288,15 @@ int aws_sdk_tcl_sqs_ReceiveMessages(Tcl_Interp *interp, const char *handle, cons
         Tcl_SetObjResult(interp, listPtr);
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 
-static int aws_sdk_tcl_sqs_SetQueueAttributes(Tcl_Interp *interp, const char *handle, const char *queue_url,
+static int aws_sdk_tcl_sqs_SetQueueAttributes(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *queue_url,
                                               Tcl_Obj *const dictPtr) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -375,19 +409,19 @@ static int aws_sdk_tcl_sqs_SetQueueAttributes(Tcl_Interp *interp, const char *ha
     if (outcome.IsSuccess()) {
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 static int aws_sdk_tcl_sqs_ChangeMessageVisibility(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *queue_url,
         const char *message_receipt_handle,
         Tcl_Obj *const visibilityTimeoutSecondsPtr
 ) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -409,18 +443,18 @@ static int aws_sdk_tcl_sqs_ChangeMessageVisibility(
     if (outcome.IsSuccess()) {
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 static int aws_sdk_tcl_sqs_DeleteMessage(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *queue_url,
         const char *message_receipt_handle
 ) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -435,18 +469,18 @@ static int aws_sdk_tcl_sqs_DeleteMessage(
     if (outcome.IsSuccess()) {
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 static int aws_sdk_tcl_sqs_DeleteMessageBatch(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *queue_url,
         Tcl_Obj *const messageReceiptHandlesPtr
 ) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -480,17 +514,17 @@ static int aws_sdk_tcl_sqs_DeleteMessageBatch(
     if (outcome.IsSuccess()) {
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
 
 static int aws_sdk_tcl_sqs_GetQueueAttributes(
         Tcl_Interp *interp,
-        const char *handle,
+        Tcl_Obj *handlePtr,
         const char *queue_url
 ) {
-    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromName(handle);
+    Aws::SQS::SQSClient *client = aws_sdk_tcl_sqs_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -511,7 +545,7 @@ static int aws_sdk_tcl_sqs_GetQueueAttributes(
         Tcl_SetObjResult(interp, dictPtr);
         return TCL_OK;
     } else {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SQS", outcome.GetError());
         return TCL_ERROR;
     }
 }
@@ -557,6 +591,8 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
     if (TCL_OK == Tcl_GetIndexFromObj(interp, objv[1], clientMethods, "method", 0, &methodIndex)) {
         Tcl_ResetResult(interp);
         const char *handle = Tcl_GetString(objv[0]);
+        aws_sdk_tcl_HandleObj handleObj(clientData);
+        Tcl_Obj *handlePtr = handleObj.objPtr;
         switch ((enum clientMethod) methodIndex) {
             case m_destroy:
                 DBG(fprintf(stderr, "DestroyMethod\n"));
@@ -567,7 +603,7 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(3, 3, 1, "create_queue queue_name");
                 return aws_sdk_tcl_sqs_CreateQueue(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_deleteQueue:
@@ -575,19 +611,19 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(3, 3, 1, "delete_queue queue_url");
                 return aws_sdk_tcl_sqs_DeleteQueue(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
             case m_listQueues:
                 DBG(fprintf(stderr, "ListQueuesMethod\n"));
                 CheckArgs(2, 2, 1, "list_queues");
-                return aws_sdk_tcl_sqs_ListQueues(interp, handle);
+                return aws_sdk_tcl_sqs_ListQueues(interp, handlePtr);
             case m_sendMessage:
                 DBG(fprintf(stderr, "SendMessageMethod\n"));
                 CheckArgs(4, 4, 1, "send_message queue_url message");
                 return aws_sdk_tcl_sqs_SendMessage(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3])
                 );
@@ -596,7 +632,7 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(3, 4, 1, "receive_messages queue_url ?max_number_of_messages?");
                 return aws_sdk_tcl_sqs_ReceiveMessages(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objc == 4 ? objv[3] : nullptr
                 );
@@ -605,7 +641,7 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(4, 4, 1, "set_queue_attributes queue_url attributes_dict");
                 return aws_sdk_tcl_sqs_SetQueueAttributes(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objv[3]
                 );
@@ -615,7 +651,7 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                           "change_message_visibility queue_url message_receipt_handle visibility_timeout_seconds");
                 return aws_sdk_tcl_sqs_ChangeMessageVisibility(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
                         objv[4]
@@ -625,7 +661,7 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(4, 4, 1, "delete_message queue_url message_receipt_handle");
                 return aws_sdk_tcl_sqs_DeleteMessage(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3])
                 );
@@ -634,7 +670,7 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(4, 4, 1, "delete_message_batch queue_url message_receipt_handles");
                 return aws_sdk_tcl_sqs_DeleteMessageBatch(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         objv[3]
                 );
@@ -643,7 +679,7 @@ int aws_sdk_tcl_sqs_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(3, 3, 1, "get_queue_attributes queue_url");
                 return aws_sdk_tcl_sqs_GetQueueAttributes(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2])
                 );
         }
@@ -685,35 +721,54 @@ char *aws_sdk_tcl_sqs_VarTraceProc(ClientData clientData, Tcl_Interp *interp, co
 static int aws_sdk_tcl_sqs_CreateCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "CreateCmd\n"));
 
-    CheckArgs(2, 3, 1, "config_dict ?varname?");
+    int shared = objc > 1 && 0 == strcmp(Tcl_GetString(objv[1]), "-shared");
+    CheckArgs(2 + shared, 3 + shared, 1, "?-shared? config_dict ?varname?");
 
-    auto result = get_client_config_and_credentials_provider(interp, objv[1]);
-    int status = std::get<0>(result);
-    if (TCL_OK != status) {
-        SetResult("Invalid config_dict");
-        return TCL_ERROR;
+    Aws::String key;
+    Aws::SQS::SQSClient *client = nullptr;
+    if (shared) {
+        if (TCL_OK != aws_sdk_tcl_GetSharedClientKey(interp, "sqs", objv[1 + shared], key)) {
+            return TCL_ERROR;
+        }
+        // the configuration and credentials are only set up for a new client
+        client = (Aws::SQS::SQSClient *) aws_sdk_tcl_FindSharedClient(key);
     }
-    Aws::Client::ClientConfiguration client_config = std::get<1>(result);
-    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+    if (!client) {
+        auto result = get_client_config_and_credentials_provider(interp, objv[1 + shared]);
+        int status = std::get<0>(result);
+        if (TCL_OK != status) {
+            return TCL_ERROR;
+        }
+        Aws::Client::ClientConfiguration client_config = std::get<1>(result);
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
 
-    auto *client = credentials_provider_ptr != nullptr ? new Aws::SQS::SQSClient(credentials_provider_ptr, client_config) : new Aws::SQS::SQSClient(client_config);
+        client = credentials_provider_ptr != nullptr ? new Aws::SQS::SQSClient(credentials_provider_ptr, client_config)
+                                                     : new Aws::SQS::SQSClient(client_config);
+        if (shared) {
+            client = (Aws::SQS::SQSClient *) aws_sdk_tcl_AddSharedClient(key, client, aws_sdk_tcl_sqs_DeleteClient);
+        }
+    }
     char handle[80];
-    CMD_NAME(handle, client);
-    aws_sdk_tcl_sqs_RegisterName(handle, client);
+    if (shared) {
+        SHARED_CMD_NAME(handle, client, aws_sdk_tcl_NewSharedHandleId());
+    } else {
+        CMD_NAME(handle, client);
+    }
+    ClientData handleRef = aws_sdk_tcl_sqs_RegisterName(handle, client);
 
     Tcl_CreateObjCommand(interp, handle,
                          (Tcl_ObjCmdProc *) aws_sdk_tcl_sqs_ClientObjCmd,
-                         nullptr,
-                         nullptr);
+                         handleRef,
+                         (Tcl_CmdDeleteProc *) aws_sdk_tcl_FreeHandleRef);
 //                                 (Tcl_CmdDeleteProc*) aws_sdk_tcl_sqs_clientObjCmdDeleteProc);
 
-    if (objc == 3) {
+    if (objc == 3 + shared) {
         auto *trace = (aws_sdk_tcl_sqs_trace_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_sqs_trace_t));
         trace->interp = interp;
-        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2]), 80);
+        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2 + shared]), 80);
         trace->handle = aws_sdk_strndup(handle, 80);
         trace->item = client;
-        const char *objVar = Tcl_GetString(objv[2]);
+        const char *objVar = Tcl_GetString(objv[2 + shared]);
         Tcl_UnsetVar(interp, objVar, 0);
         Tcl_SetVar  (interp, objVar, handle, 0);
         Tcl_TraceVar(interp,objVar,TCL_TRACE_WRITES|TCL_TRACE_UNSETS,
@@ -736,7 +791,7 @@ static int aws_sdk_tcl_sqs_CreateQueueCmd(ClientData clientData, Tcl_Interp *int
     CheckArgs(3, 3, 1, "handle queue_name");
     return aws_sdk_tcl_sqs_CreateQueue(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2])
     );
 }
@@ -746,7 +801,7 @@ static int aws_sdk_tcl_sqs_DeleteQueueCmd(ClientData clientData, Tcl_Interp *int
     CheckArgs(3, 3, 1, "handle queue_url");
     return aws_sdk_tcl_sqs_DeleteQueue(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2])
     );
 }
@@ -754,7 +809,7 @@ static int aws_sdk_tcl_sqs_DeleteQueueCmd(ClientData clientData, Tcl_Interp *int
 static int aws_sdk_tcl_sqs_ListQueuesCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "ListQueuesCmd\n"));
     CheckArgs(2, 2, 1, "handle");
-    return aws_sdk_tcl_sqs_ListQueues(interp, Tcl_GetString(objv[1]));
+    return aws_sdk_tcl_sqs_ListQueues(interp, objv[1]);
 }
 
 static int aws_sdk_tcl_sqs_SendMessageCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
@@ -762,7 +817,7 @@ static int aws_sdk_tcl_sqs_SendMessageCmd(ClientData clientData, Tcl_Interp *int
     CheckArgs(4, 4, 1, "handle queue_url message");
     return aws_sdk_tcl_sqs_SendMessage(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             Tcl_GetString(objv[3])
     );
@@ -774,7 +829,7 @@ aws_sdk_tcl_sqs_ReceiveMessagesCmd(ClientData clientData, Tcl_Interp *interp, in
     CheckArgs(3, 4, 1, "handle queue_url ?max_number_of_messages?");
     return aws_sdk_tcl_sqs_ReceiveMessages(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             objc == 4 ? objv[3] : nullptr
     );
@@ -786,7 +841,7 @@ aws_sdk_tcl_sqs_SetQueueAttributesCmd(ClientData clientData, Tcl_Interp *interp,
     CheckArgs(4, 4, 1, "handle queue_url attributes_dict");
     return aws_sdk_tcl_sqs_SetQueueAttributes(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             objv[3]
     );
@@ -798,7 +853,7 @@ aws_sdk_tcl_sqs_ChangeMessageVisibilityCmd(ClientData clientData, Tcl_Interp *in
     CheckArgs(5, 5, 1, "handle queue_url message_receipt_handle visibility_timeout_seconds");
     return aws_sdk_tcl_sqs_ChangeMessageVisibility(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             Tcl_GetString(objv[3]),
             objv[4]
@@ -811,7 +866,7 @@ aws_sdk_tcl_sqs_DeleteMessageCmd(ClientData clientData, Tcl_Interp *interp, int
     CheckArgs(4, 4, 1, "handle queue_url message_receipt_handle");
     return aws_sdk_tcl_sqs_DeleteMessage(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             Tcl_GetString(objv[3])
     );
@@ -823,7 +878,7 @@ aws_sdk_tcl_sqs_DeleteMessageBatchCmd(ClientData clientData, Tcl_Interp *interp,
     CheckArgs(4, 4, 1, "handle queue_url message_receipt_handles");
     return aws_sdk_tcl_sqs_DeleteMessageBatch(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             objv[3]
     );
@@ -835,17 +890,16 @@ aws_sdk_tcl_sqs_GetQueueAttributesCmd(ClientData clientData, Tcl_Interp *interp,
     CheckArgs(3, 3, 1, "handle queue_url");
     return aws_sdk_tcl_sqs_GetQueueAttributes(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2])
     );
 }
 
-static Aws::SDKOptions options;
-
 static void aws_sdk_tcl_sqs_ExitHandler(ClientData unused) {
     Tcl_MutexLock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
     Tcl_DeleteHashTable(&aws_sdk_tcl_sqs_NameToInternal_HT);
-    Aws::ShutdownAPI(options);
+    aws_sdk_tcl_ShutdownAPI();
+    aws_sdk_tcl_sqs_ModuleInitialized = 0;
     Tcl_MutexUnlock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
 
 }
@@ -854,7 +908,7 @@ static void aws_sdk_tcl_sqs_ExitHandler(ClientData unused) {
 void aws_sdk_tcl_sqs_InitModule() {
     Tcl_MutexLock(&aws_sdk_tcl_sqs_NameToInternal_HT_Mutex);
     if (!aws_sdk_tcl_sqs_ModuleInitialized) {
-        Aws::InitAPI(options);
+        aws_sdk_tcl_InitAPI();
         Tcl_InitHashTable(&aws_sdk_tcl_sqs_NameToInternal_HT, TCL_STRING_KEYS);
         Tcl_CreateThreadExitHandler(aws_sdk_tcl_sqs_ExitHandler, nullptr);
         aws_sdk_tcl_sqs_ModuleInitialized = 1;
@@ -878,6 +932,7 @@ int Aws_sdk_tcl_sqs_Init(Tcl_Interp *interp) {
     aws_sdk_tcl_sqs_InitModule();
 
     Tcl_CreateNamespace(interp, "::aws::sqs", nullptr, nullptr);
+    aws_sdk_tcl_CreateCommonCmds(interp);
     Tcl_CreateObjCommand(interp, "::aws::sqs::create", aws_sdk_tcl_sqs_CreateCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::sqs::destroy", aws_sdk_tcl_sqs_DestroyCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::sqs::create_queue", aws_sdk_tcl_sqs_CreateQueueCmd, nullptr, nullptr);
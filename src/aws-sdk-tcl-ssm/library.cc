@@ -40,6 +40,7 @@ typedef int Tcl_Size;
                  }
 
 #define CMD_NAME(s, internal) std::sprintf((s), "_AWS_SSM_%p", (internal))
+#define SHARED_CMD_NAME(s, internal, id) std::sprintf((s), "_AWS_SSM_%p_%lu", (internal), (id))
 
 static char VAR_READ_ONLY_MSG[] = "var is read-only";
 
@@ -63,7 +64,7 @@ static char client_usage[] =
         ;
 
 
-static int
+static ClientData
 aws_sdk_tcl_ssm_RegisterName(const char *name, Aws::SSM::SSMClient *internal) {
 
     Tcl_HashEntry *entryPtr;
@@ -72,14 +73,16 @@ aws_sdk_tcl_ssm_RegisterName(const char *name, Aws::SSM::SSMClient *internal) {
     Tcl_MutexLock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
     entryPtr = Tcl_CreateHashEntry(&aws_sdk_tcl_ssm_NameToInternal_HT, (char *) name, &newEntry);
     if (newEntry) {
-        Tcl_SetHashValue(entryPtr, (ClientData) internal);
+        Tcl_SetHashValue(entryPtr, (ClientData) aws_sdk_tcl_AllocSlot(&aws_sdk_tcl_ssm_NameToInternal_HT, internal));
     }
+    // becomes the clientData of the handle command
+    ClientData handleRef = aws_sdk_tcl_NewHandleRef((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr), name);
     Tcl_MutexUnlock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
 
     DBG(fprintf(stderr, "--> RegisterName: name=%s internal=%p %s\n", name, internal,
                 newEntry ? "entered into" : "already in"));
 
-    return !!newEntry;
+    return handleRef;
 }
 
 static int
@@ -90,6 +93,7 @@ aws_sdk_tcl_ssm_UnregisterName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_ssm_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
+        aws_sdk_tcl_FreeSlot((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
         Tcl_DeleteHashEntry(entryPtr);
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
@@ -107,27 +111,57 @@ aws_sdk_tcl_ssm_GetInternalFromName(const char *name) {
     Tcl_MutexLock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
     entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_ssm_NameToInternal_HT, (char *) name);
     if (entryPtr != nullptr) {
-        internal = (Aws::SSM::SSMClient *) Tcl_GetHashValue(entryPtr);
+        internal = (Aws::SSM::SSMClient *) aws_sdk_tcl_GetSlotItem((aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
     }
     Tcl_MutexUnlock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
 
     return internal;
 }
 
+static Aws::SSM::SSMClient *
+aws_sdk_tcl_ssm_GetInternalFromObj(Tcl_Obj *objPtr) {
+    // no locking once the object caches the slot of the handle
+    auto *internal = (Aws::SSM::SSMClient *) aws_sdk_tcl_GetCachedItem(objPtr, &aws_sdk_tcl_ssm_NameToInternal_HT);
+    if (internal == nullptr) {
+        Tcl_HashEntry *entryPtr;
+
+        Tcl_MutexLock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
+        entryPtr = Tcl_FindHashEntry(&aws_sdk_tcl_ssm_NameToInternal_HT, Tcl_GetString(objPtr));
+        if (entryPtr != nullptr) {
+            internal = (Aws::SSM::SSMClient *) aws_sdk_tcl_SetCachedItem(objPtr, (aws_sdk_tcl_slot_t *) Tcl_GetHashValue(entryPtr));
+        }
+        Tcl_MutexUnlock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
+    }
+
+    return internal;
+}
+
+static void
+aws_sdk_tcl_ssm_DeleteClient(void *client) {
+    delete (Aws::SSM::SSMClient *) client;
+}
+
 int aws_sdk_tcl_ssm_Destroy(Tcl_Interp *interp, const char *handle) {
     Aws::SSM::SSMClient *client = aws_sdk_tcl_ssm_GetInternalFromName(handle);
+    if (!client) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
+        return TCL_ERROR;
+    }
     if (!aws_sdk_tcl_ssm_UnregisterName(handle)) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
     }
-    delete client;
+    // a shared client is only destroyed with its last handle
+    if (aws_sdk_tcl_ReleaseSharedClient(client)) {
+        aws_sdk_tcl_ssm_DeleteClient(client);
+    }
     Tcl_DeleteCommand(interp, handle);
     Tcl_SetObjResult(interp, Tcl_NewStringObj(handle, -1));
     return TCL_OK;
 }
 
-int aws_sdk_tcl_ssm_PutParameter(Tcl_Interp *interp, const char *handle, const char *name, const char *value, Tcl_Obj *type, int overwrite) {
-    Aws::SSM::SSMClient *client = aws_sdk_tcl_ssm_GetInternalFromName(handle);
+int aws_sdk_tcl_ssm_PutParameter(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *name, const char *value, Tcl_Obj *type, int overwrite) {
+    Aws::SSM::SSMClient *client = aws_sdk_tcl_ssm_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -155,15 +189,15 @@ int aws_sdk_tcl_ssm_PutParameter(Tcl_Interp *interp, const char *handle, const c
 
     auto outcome = client->PutParameter(request);
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SSM", outcome.GetError());
         return TCL_ERROR;
     }
 
     return TCL_OK;
 }
 
-int aws_sdk_tcl_ssm_GetParameter(Tcl_Interp *interp, const char *handle, const char *name, int with_decryption) {
-    Aws::SSM::SSMClient *client = aws_sdk_tcl_ssm_GetInternalFromName(handle);
+int aws_sdk_tcl_ssm_GetParameter(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *name, int with_decryption) {
+    Aws::SSM::SSMClient *client = aws_sdk_tcl_ssm_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -175,7 +209,7 @@ int aws_sdk_tcl_ssm_GetParameter(Tcl_Interp *interp, const char *handle, const c
 
     auto outcome = client->GetParameter(request);
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SSM", outcome.GetError());
         return TCL_ERROR;
     }
 
@@ -203,8 +237,8 @@ int aws_sdk_tcl_ssm_GetParameter(Tcl_Interp *interp, const char *handle, const c
     return TCL_OK;
 }
 
-int aws_sdk_tcl_ssm_DeleteParameter(Tcl_Interp *interp, const char *handle, const char *name) {
-    Aws::SSM::SSMClient *client = aws_sdk_tcl_ssm_GetInternalFromName(handle);
+int aws_sdk_tcl_ssm_DeleteParameter(Tcl_Interp *interp, Tcl_Obj *handlePtr, const char *name) {
+    Aws::SSM::SSMClient *client = aws_sdk_tcl_ssm_GetInternalFromObj(handlePtr);
     if (!client) {
         Tcl_SetObjResult(interp, Tcl_NewStringObj("handle not found", -1));
         return TCL_ERROR;
@@ -215,7 +249,7 @@ int aws_sdk_tcl_ssm_DeleteParameter(Tcl_Interp *interp, const char *handle, cons
 
     auto outcome = client->DeleteParameter(request);
     if (!outcome.IsSuccess()) {
-        Tcl_SetObjResult(interp, Tcl_NewStringObj(outcome.GetError().GetMessage().c_str(), -1));
+        aws_sdk_tcl_SetErrorResult(interp, "SSM", outcome.GetError());
         return TCL_ERROR;
     }
     return TCL_OK;
@@ -249,6 +283,8 @@ int aws_sdk_tcl_ssm_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
     if (TCL_OK == Tcl_GetIndexFromObj(interp, objv[1], clientMethods, "method", 0, &methodIndex)) {
         Tcl_ResetResult(interp);
         const char *handle = Tcl_GetString(objv[0]);
+        aws_sdk_tcl_HandleObj handleObj(clientData);
+        Tcl_Obj *handlePtr = handleObj.objPtr;
         switch ((enum clientMethod) methodIndex) {
             case m_destroy:
                 return aws_sdk_tcl_ssm_Destroy(interp, handle);
@@ -263,7 +299,7 @@ int aws_sdk_tcl_ssm_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 }
                 return aws_sdk_tcl_ssm_PutParameter(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         Tcl_GetString(objv[3]),
                         objc >= 5 ? objv[4] : nullptr,
@@ -280,7 +316,7 @@ int aws_sdk_tcl_ssm_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 }
                 return aws_sdk_tcl_ssm_GetParameter(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]),
                         with_decryption);
             }
@@ -288,7 +324,7 @@ int aws_sdk_tcl_ssm_ClientObjCmd(ClientData clientData, Tcl_Interp *interp, int
                 CheckArgs(3, 3, 1, "delete_parameter name");
                 return aws_sdk_tcl_ssm_DeleteParameter(
                         interp,
-                        handle,
+                        handlePtr,
                         Tcl_GetString(objv[2]));
         }
     }
@@ -329,36 +365,55 @@ char *aws_sdk_tcl_ssm_VarTraceProc(ClientData clientData, Tcl_Interp *interp, co
 static int aws_sdk_tcl_ssm_CreateCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
     DBG(fprintf(stderr, "CreateCmd\n"));
 
-    CheckArgs(2, 3, 1, "config_dict ?varname?");
+    int shared = objc > 1 && 0 == strcmp(Tcl_GetString(objv[1]), "-shared");
+    CheckArgs(2 + shared, 3 + shared, 1, "?-shared? config_dict ?varname?");
 
-    auto result = get_client_config_and_credentials_provider(interp, objv[1]);
-    int status = std::get<0>(result);
-    if (TCL_OK != status) {
-        SetResult("Invalid config_dict");
-        return TCL_ERROR;
+    Aws::String key;
+    Aws::SSM::SSMClient *client = nullptr;
+    if (shared) {
+        if (TCL_OK != aws_sdk_tcl_GetSharedClientKey(interp, "ssm", objv[1 + shared], key)) {
+            return TCL_ERROR;
+        }
+        // the configuration and credentials are only set up for a new client
+        client = (Aws::SSM::SSMClient *) aws_sdk_tcl_FindSharedClient(key);
     }
-    Aws::Client::ClientConfiguration client_config = std::get<1>(result);
-    std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
+    if (!client) {
+        auto result = get_client_config_and_credentials_provider(interp, objv[1 + shared]);
+        int status = std::get<0>(result);
+        if (TCL_OK != status) {
+            return TCL_ERROR;
+        }
+        Aws::Client::ClientConfiguration client_config = std::get<1>(result);
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = std::get<2>(result);
 
-    auto *client = credentials_provider_ptr != nullptr ? new Aws::SSM::SSMClient(credentials_provider_ptr, client_config) : new Aws::SSM::SSMClient(client_config);
+        client = credentials_provider_ptr != nullptr ? new Aws::SSM::SSMClient(credentials_provider_ptr, client_config)
+                                                     : new Aws::SSM::SSMClient(client_config);
+        if (shared) {
+            client = (Aws::SSM::SSMClient *) aws_sdk_tcl_AddSharedClient(key, client, aws_sdk_tcl_ssm_DeleteClient);
+        }
+    }
     char handle[80];
-    CMD_NAME(handle, client);
-    aws_sdk_tcl_ssm_RegisterName(handle, client);
+    if (shared) {
+        SHARED_CMD_NAME(handle, client, aws_sdk_tcl_NewSharedHandleId());
+    } else {
+        CMD_NAME(handle, client);
+    }
+    ClientData handleRef = aws_sdk_tcl_ssm_RegisterName(handle, client);
 
     Tcl_CreateObjCommand(interp, handle,
                          (Tcl_ObjCmdProc *) aws_sdk_tcl_ssm_ClientObjCmd,
-                         nullptr,
-                         nullptr);
+                         handleRef,
+                         (Tcl_CmdDeleteProc *) aws_sdk_tcl_FreeHandleRef);
 //                                 (Tcl_CmdDeleteProc*) aws_sdk_tcl_ssm_clientObjCmdDeleteProc);
 
 
-    if (objc == 3) {
+    if (objc == 3 + shared) {
         auto *trace = (aws_sdk_tcl_ssm_trace_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_ssm_trace_t));
         trace->interp = interp;
-        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2]), 80);
+        trace->varname = aws_sdk_strndup(Tcl_GetString(objv[2 + shared]), 80);
         trace->handle = aws_sdk_strndup(handle, 80);
         trace->item = client;
-        const char *objVar = Tcl_GetString(objv[2]);
+        const char *objVar = Tcl_GetString(objv[2 + shared]);
         Tcl_UnsetVar(interp, objVar, 0);
         Tcl_SetVar  (interp, objVar, handle, 0);
         Tcl_TraceVar(interp,objVar,TCL_TRACE_WRITES|TCL_TRACE_UNSETS,
@@ -390,7 +445,7 @@ static int aws_sdk_tcl_ssm_PutParameterCmd(ClientData clientData, Tcl_Interp *in
 
     return aws_sdk_tcl_ssm_PutParameter(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             Tcl_GetString(objv[3]),
             objc >= 5 ? objv[4]: nullptr,
@@ -410,7 +465,7 @@ static int aws_sdk_tcl_ssm_GetParameterCmd(ClientData clientData, Tcl_Interp *in
     }
     return aws_sdk_tcl_ssm_GetParameter(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2]),
             with_decryption);
 }
@@ -420,17 +475,16 @@ static int aws_sdk_tcl_ssm_DeleteParameterCmd(ClientData clientData, Tcl_Interp
     CheckArgs(3, 3, 1, "handle name");
     return aws_sdk_tcl_ssm_DeleteParameter(
             interp,
-            Tcl_GetString(objv[1]),
+            objv[1],
             Tcl_GetString(objv[2])
     );
 }
 
-static Aws::SDKOptions options;
-
 static void aws_sdk_tcl_ssm_ExitHandler(ClientData unused) {
     Tcl_MutexLock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
     Tcl_DeleteHashTable(&aws_sdk_tcl_ssm_NameToInternal_HT);
-    Aws::ShutdownAPI(options);
+    aws_sdk_tcl_ShutdownAPI();
+    aws_sdk_tcl_ssm_ModuleInitialized = 0;
     Tcl_MutexUnlock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
 
 }
@@ -439,7 +493,7 @@ static void aws_sdk_tcl_ssm_ExitHandler(ClientData unused) {
 void aws_sdk_tcl_ssm_InitModule() {
     Tcl_MutexLock(&aws_sdk_tcl_ssm_NameToInternal_HT_Mutex);
     if (!aws_sdk_tcl_ssm_ModuleInitialized) {
-        Aws::InitAPI(options);
+        aws_sdk_tcl_InitAPI();
         Tcl_InitHashTable(&aws_sdk_tcl_ssm_NameToInternal_HT, TCL_STRING_KEYS);
         Tcl_CreateThreadExitHandler(aws_sdk_tcl_ssm_ExitHandler, nullptr);
         aws_sdk_tcl_ssm_ModuleInitialized = 1;
@@ -463,6 +517,7 @@ int Aws_sdk_tcl_ssm_Init(Tcl_Interp *interp) {
     aws_sdk_tcl_ssm_InitModule();
 
     Tcl_CreateNamespace(interp, "::aws::ssm", nullptr, nullptr);
+    aws_sdk_tcl_CreateCommonCmds(interp);
     Tcl_CreateObjCommand(interp, "::aws::ssm::create", aws_sdk_tcl_ssm_CreateCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::ssm::destroy", aws_sdk_tcl_ssm_DestroyCmd, nullptr, nullptr);
     Tcl_CreateObjCommand(interp, "::aws::ssm::put_parameter", aws_sdk_tcl_ssm_PutParameterCmd, nullptr, nullptr);
@@ -1,4 +1,708 @@
 #include "common.h"
+#include <aws/core/utils/threading/Executor.h>
+#include <aws/core/auth/AWSCredentialsProviderChain.h>
+#include <aws/core/auth/STSCredentialsProvider.h>
+#include <aws/core/platform/Environment.h>
+#include <aws/core/client/RetryStrategy.h>
+#include <aws/core/client/AdaptiveRetryStrategy.h>
+#include <aws/core/monitoring/MonitoringInterface.h>
+#include <aws/core/monitoring/MonitoringFactory.h>
+#include <aws/core/http/HttpRequest.h>
+#include <aws/core/http/HttpResponse.h>
+#include <aws/core/monitoring/HttpClientMetrics.h>
+#include <aws/core/utils/HashingUtils.h>
+#include <aws/sts/STSClient.h>
+#include <aws/sts/model/AssumeRoleRequest.h>
+#include <aws/sts/model/AssumeRoleWithWebIdentityRequest.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <cmath>
+#include <climits>
+
+#ifndef TCL_SIZE_MAX
+typedef int Tcl_Size;
+#endif
+
+static Aws::SDKOptions aws_sdk_tcl_options;
+static int aws_sdk_tcl_InitCount = 0;
+static Tcl_Mutex aws_sdk_tcl_InitMutex;
+
+// A fixed number of threads serving a bounded queue of tasks. Submitting
+// to a full queue blocks the caller until a slot frees up, unless the
+// caller is one of the pool threads, which then runs the task itself to
+// avoid waiting on its own pool. The threads share the queue rather than
+// the executor, which can be destroyed by one of its own tasks when that
+// task drops the last reference.
+class aws_sdk_tcl_BoundedExecutor : public Aws::Utils::Threading::Executor {
+public:
+    aws_sdk_tcl_BoundedExecutor(size_t threads, size_t queue_size) : m_state(std::make_shared<State>()) {
+        m_state->queue_size = queue_size;
+        m_state->stopping = false;
+        std::shared_ptr<State> state = m_state;
+        for (size_t i = 0; i < threads; i++) {
+            m_threads.emplace_back([state] { Run(state); });
+        }
+    }
+
+    ~aws_sdk_tcl_BoundedExecutor() override {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->stopping = true;
+        }
+        m_state->not_empty.notify_all();
+        m_state->not_full.notify_all();
+        for (auto &thread: m_threads) {
+            // a thread cannot join itself, it finishes the queue and exits
+            if (thread.get_id() == std::this_thread::get_id()) {
+                thread.detach();
+            } else {
+                thread.join();
+            }
+        }
+    }
+
+protected:
+    bool SubmitToThread(std::function<void()> &&task) override {
+        State &state = *m_state;
+        std::unique_lock<std::mutex> lock(state.mutex);
+        if (state.queue_size > 0 && state.queue.size() >= state.queue_size) {
+            if (current == &state) {
+                lock.unlock();
+                task();
+                return true;
+            }
+            state.not_full.wait(lock, [&state] { return state.stopping || state.queue.size() < state.queue_size; });
+        }
+        if (state.stopping) {
+            return false;
+        }
+        state.queue.push_back(std::move(task));
+        lock.unlock();
+        state.not_empty.notify_one();
+        return true;
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::deque<std::function<void()>> queue;
+        size_t queue_size;
+        bool stopping;
+    };
+
+    static void Run(const std::shared_ptr<State> &state) {
+        current = state.get();
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->not_empty.wait(lock, [&state] { return state->stopping || !state->queue.empty(); });
+                // pending tasks are still run on shutdown, their futures are awaited
+                if (state->queue.empty()) {
+                    return;
+                }
+                task = std::move(state->queue.front());
+                state->queue.pop_front();
+            }
+            state->not_full.notify_one();
+            task();
+        }
+    }
+
+    static thread_local State *current;
+    std::shared_ptr<State> m_state;
+    std::vector<std::thread> m_threads;
+};
+
+thread_local aws_sdk_tcl_BoundedExecutor::State *aws_sdk_tcl_BoundedExecutor::current = nullptr;
+
+// Named executors are shared by all the clients of all the modules that
+// ask for the same name. The first client that names an executor decides
+// its number of threads and queue size.
+static Aws::Map<Aws::String, std::shared_ptr<Aws::Utils::Threading::Executor>> aws_sdk_tcl_Executors;
+static Tcl_Mutex aws_sdk_tcl_ExecutorsMutex;
+
+static std::shared_ptr<Aws::Utils::Threading::Executor>
+aws_sdk_tcl_GetExecutor(const char *name, size_t threads, size_t queue_size) {
+    if (name == nullptr) {
+        return std::make_shared<aws_sdk_tcl_BoundedExecutor>(threads, queue_size);
+    }
+    Tcl_MutexLock(&aws_sdk_tcl_ExecutorsMutex);
+    std::shared_ptr<Aws::Utils::Threading::Executor> &executor = aws_sdk_tcl_Executors[name];
+    if (!executor) {
+        executor = std::make_shared<aws_sdk_tcl_BoundedExecutor>(threads, queue_size);
+    }
+    std::shared_ptr<Aws::Utils::Threading::Executor> result = executor;
+    Tcl_MutexUnlock(&aws_sdk_tcl_ExecutorsMutex);
+    return result;
+}
+
+static int
+aws_sdk_tcl_GetUnsignedKey(Tcl_Interp *interp, Tcl_Obj *dict_ptr, const char *key, Tcl_WideInt *value_ptr, int *found_ptr) {
+    Tcl_Obj *value;
+    *found_ptr = 0;
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, dict_ptr, key, &value)) {
+        return TCL_ERROR;
+    }
+    if (value) {
+        if (TCL_OK != Tcl_GetWideIntFromObj(interp, value, value_ptr)) {
+            return TCL_ERROR;
+        }
+        if (*value_ptr < 0) {
+            Tcl_SetObjResult(interp, Tcl_ObjPrintf("%s: unsigned integer >= 0 is expected,"
+                " but got \"%s\"", key, Tcl_GetString(value)));
+            return TCL_ERROR;
+        }
+        *found_ptr = 1;
+    }
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_GetBooleanKey(Tcl_Interp *interp, Tcl_Obj *dict_ptr, const char *key, bool &value_ref) {
+    Tcl_Obj *value;
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, dict_ptr, key, &value)) {
+        return TCL_ERROR;
+    }
+    if (value) {
+        int flag;
+        if (TCL_OK != Tcl_GetBooleanFromObj(interp, value, &flag)) {
+            return TCL_ERROR;
+        }
+        value_ref = flag;
+    }
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_GetStringKey(Tcl_Interp *interp, Tcl_Obj *dict_ptr, const char *key, Aws::String &value_ref) {
+    Tcl_Obj *value;
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, dict_ptr, key, &value)) {
+        return TCL_ERROR;
+    }
+    if (value) {
+        value_ref = Tcl_GetString(value);
+    }
+    return TCL_OK;
+}
+
+// Applies the HTTP, connection pool and proxy settings of the config dict,
+// the SDK defaults are kept for the keys that are not given.
+static int
+aws_sdk_tcl_GetHttpConfig(Tcl_Interp *interp, Tcl_Obj *dict_ptr, Aws::Client::ClientConfiguration &clientConfig) {
+    Tcl_WideInt value;
+    int found;
+
+    if (TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "maxConnections", &value, &found)) {
+        return TCL_ERROR;
+    }
+    if (found) {
+        clientConfig.maxConnections = (unsigned) value;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "connectTimeoutMs", &value, &found)) {
+        return TCL_ERROR;
+    }
+    if (found) {
+        clientConfig.connectTimeoutMs = (long) value;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "requestTimeoutMs", &value, &found)) {
+        return TCL_ERROR;
+    }
+    if (found) {
+        clientConfig.requestTimeoutMs = (long) value;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "httpRequestTimeoutMs", &value, &found)) {
+        return TCL_ERROR;
+    }
+    if (found) {
+        clientConfig.httpRequestTimeoutMs = (long) value;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "tcpKeepAliveIntervalMs", &value, &found)) {
+        return TCL_ERROR;
+    }
+    if (found) {
+        clientConfig.tcpKeepAliveIntervalMs = (unsigned long) value;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "lowSpeedLimit", &value, &found)) {
+        return TCL_ERROR;
+    }
+    if (found) {
+        clientConfig.lowSpeedLimit = (unsigned long) value;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetBooleanKey(interp, dict_ptr, "enableTcpKeepAlive", clientConfig.enableTcpKeepAlive)
+        || TCL_OK != aws_sdk_tcl_GetBooleanKey(interp, dict_ptr, "verifySSL", clientConfig.verifySSL)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "caFile", clientConfig.caFile)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "caPath", clientConfig.caPath)) {
+        return TCL_ERROR;
+    }
+
+    Tcl_Obj *proxy_scheme;
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, dict_ptr, "proxyScheme", &proxy_scheme)) {
+        return TCL_ERROR;
+    }
+    if (proxy_scheme) {
+        static const char *const schemes[] = { "http", "https", NULL };
+        int scheme;
+        if (TCL_OK != Tcl_GetIndexFromObj(interp, proxy_scheme, schemes, "proxyScheme", 0, &scheme)) {
+            return TCL_ERROR;
+        }
+        clientConfig.proxyScheme = scheme == 0 ? Aws::Http::Scheme::HTTP : Aws::Http::Scheme::HTTPS;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "proxyPort", &value, &found)) {
+        return TCL_ERROR;
+    }
+    if (found) {
+        clientConfig.proxyPort = (unsigned) value;
+    }
+    if (TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "proxyHost", clientConfig.proxyHost)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "proxyUserName", clientConfig.proxyUserName)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "proxyPassword", clientConfig.proxyPassword)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "proxyCaFile", clientConfig.proxyCaFile)) {
+        return TCL_ERROR;
+    }
+    return TCL_OK;
+}
+
+static int
+aws_sdk_tcl_GetExecutorConfig(Tcl_Interp *interp, Tcl_Obj *dict_ptr, Aws::Client::ClientConfiguration &clientConfig) {
+    Tcl_Obj *name;
+    Tcl_WideInt threads, queue_size;
+    int threads_found, queue_size_found;
+
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, dict_ptr, "executor", &name)
+        || TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "executorThreads", &threads, &threads_found)
+        || TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "executorQueueSize", &queue_size, &queue_size_found)) {
+        return TCL_ERROR;
+    }
+    if (!name && !threads_found && !queue_size_found) {
+        return TCL_OK;
+    }
+    if (!threads_found || threads == 0) {
+        threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 4;
+    }
+    if (!queue_size_found) {
+        queue_size = 1024;
+    }
+    clientConfig.executor = aws_sdk_tcl_GetExecutor(name ? Tcl_GetString(name) : nullptr, (size_t) threads, (size_t) queue_size);
+    return TCL_OK;
+}
+
+// Adds a configurable exponential backoff with full jitter to the retry
+// modes of the SDK, the delay before retry n is random in
+// [0, min(cap, base * 2^n)]. Without a base and cap the SDK delay is kept.
+template<class Strategy>
+class aws_sdk_tcl_BackoffRetryStrategy : public Strategy {
+public:
+    aws_sdk_tcl_BackoffRetryStrategy(long max_attempts, long base_ms, long cap_ms)
+            : Strategy(max_attempts), m_base_ms(base_ms), m_cap_ms(cap_ms) {}
+
+    long CalculateDelayBeforeNextRetry(const Aws::Client::AWSError<Aws::Client::CoreErrors> &error,
+                                       long attemptedRetries) const override {
+        if (m_base_ms <= 0) {
+            return Strategy::CalculateDelayBeforeNextRetry(error, attemptedRetries);
+        }
+        static thread_local std::minstd_rand generator(std::random_device{}());
+        double ceiling = std::min((double) m_cap_ms, (double) m_base_ms * std::pow(2.0, (double) attemptedRetries));
+        return (long) std::uniform_real_distribution<double>(0.0, ceiling)(generator);
+    }
+
+private:
+    long m_base_ms;
+    long m_cap_ms;
+};
+
+// Both modes retry with a quota of retry tokens, the adaptive mode also
+// rate limits the requests of the client with a token bucket that shrinks
+// on throttling errors. Each client gets a strategy of its own, shared
+// clients share it. The strategy is left unset when no key asks for one.
+static int
+aws_sdk_tcl_GetRetryConfig(Tcl_Interp *interp, Tcl_Obj *dict_ptr, std::shared_ptr<Aws::Client::RetryStrategy> &strategy) {
+    Tcl_Obj *mode;
+    Tcl_WideInt max_attempts, base_ms, cap_ms;
+    int max_attempts_found, base_found, cap_found;
+
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, dict_ptr, "retryMode", &mode)
+        || TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "maxAttempts", &max_attempts, &max_attempts_found)
+        || TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "retryBackoffBaseMs", &base_ms, &base_found)
+        || TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "retryBackoffCapMs", &cap_ms, &cap_found)) {
+        return TCL_ERROR;
+    }
+    if (!mode && !max_attempts_found && !base_found && !cap_found) {
+        return TCL_OK;
+    }
+    int adaptive = 0;
+    if (mode) {
+        static const char *const modes[] = { "standard", "adaptive", NULL };
+        if (TCL_OK != Tcl_GetIndexFromObj(interp, mode, modes, "retryMode", 0, &adaptive)) {
+            return TCL_ERROR;
+        }
+    }
+    if (!max_attempts_found) {
+        max_attempts = 3;
+    } else if (max_attempts == 0) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("maxAttempts: at least 1 attempt is expected", -1));
+        return TCL_ERROR;
+    }
+    if (!base_found) {
+        base_ms = cap_found ? 1000 : 0;
+    }
+    if (!cap_found) {
+        cap_ms = 20000;
+    }
+    if (adaptive) {
+        strategy = std::make_shared<aws_sdk_tcl_BackoffRetryStrategy<Aws::Client::AdaptiveRetryStrategy>>(
+                (long) max_attempts, (long) base_ms, (long) cap_ms);
+    } else {
+        strategy = std::make_shared<aws_sdk_tcl_BackoffRetryStrategy<Aws::Client::StandardRetryStrategy>>(
+                (long) max_attempts, (long) base_ms, (long) cap_ms);
+    }
+    return TCL_OK;
+}
+
+// Serves cached credentials and fetches new ones on a thread of its own
+// shortly before they expire, so that no request waits on a fetch. A
+// failed fetch keeps the previous credentials and is retried.
+class aws_sdk_tcl_RefreshingCredentialsProvider : public Aws::Auth::AWSCredentialsProvider {
+public:
+    typedef std::function<Aws::Auth::AWSCredentials(Aws::String &error)> fetch_fn_t;
+
+    explicit aws_sdk_tcl_RefreshingCredentialsProvider(fetch_fn_t fetch_fn) : m_fetch_fn(std::move(fetch_fn)), m_stopping(false) {
+        m_credentials = m_fetch_fn(m_error);
+        m_thread = std::thread([this] { Run(); });
+    }
+
+    ~aws_sdk_tcl_RefreshingCredentialsProvider() override {
+        Stop();
+    }
+
+    // Stops the refreshes, the cached credentials are still served.
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_stop.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    Aws::Auth::AWSCredentials GetAWSCredentials() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_credentials;
+    }
+
+    Aws::String GetError() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_error;
+    }
+
+private:
+    int64_t NextRefreshMs() const {
+        const int64_t refresh_before_expiry_ms = 5 * 60 * 1000;
+        const int64_t max_refresh_interval_ms = 15 * 60 * 1000;
+        const int64_t retry_interval_ms = 10 * 1000;
+
+        if (m_credentials.IsEmpty() || !m_error.empty()) {
+            return retry_interval_ms;
+        }
+        // credentials without an expiration are fetched again every so often
+        int64_t remaining = m_credentials.GetExpiration().Millis() - Aws::Utils::DateTime::Now().Millis();
+        int64_t delay = remaining > 2 * refresh_before_expiry_ms ? remaining - refresh_before_expiry_ms : remaining / 2;
+        return std::max<int64_t>(1000, std::min(delay, max_refresh_interval_ms));
+    }
+
+    void Run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stopping) {
+            if (m_stop.wait_for(lock, std::chrono::milliseconds(NextRefreshMs()), [this] { return m_stopping; })) {
+                break;
+            }
+            lock.unlock();
+            Aws::String error;
+            Aws::Auth::AWSCredentials credentials = m_fetch_fn(error);
+            lock.lock();
+            if (!credentials.IsEmpty()) {
+                m_credentials = credentials;
+            }
+            m_error = credentials.IsEmpty() && error.empty() ? "no credentials were returned" : error;
+        }
+    }
+
+    fetch_fn_t m_fetch_fn;
+    Aws::Auth::AWSCredentials m_credentials;
+    Aws::String m_error;
+    std::mutex m_mutex;
+    std::condition_variable m_stop;
+    std::thread m_thread;
+    bool m_stopping;
+};
+
+// Secrets only enter the keys of the shared providers and clients as
+// digests, so that they are not kept in the clear any longer than the
+// SDK keeps them.
+static Aws::String
+aws_sdk_tcl_HashSecret(const Aws::String &secret) {
+    return Aws::Utils::HashingUtils::HexEncode(Aws::Utils::HashingUtils::CalculateSHA256(secret));
+}
+
+// Refreshing providers are shared by all the clients of all the modules
+// that ask for the same credentials, they live as long as their clients.
+static Aws::Map<Aws::String, std::weak_ptr<aws_sdk_tcl_RefreshingCredentialsProvider>> aws_sdk_tcl_CredentialsProviders;
+static Tcl_Mutex aws_sdk_tcl_CredentialsProvidersMutex;
+
+static int
+aws_sdk_tcl_ReadFile(const Aws::String &path, Aws::String &contents, Aws::String &error) {
+    std::ifstream file(path.c_str());
+    if (!file) {
+        error = "could not read " + path;
+        return TCL_ERROR;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str().c_str();
+    // a trailing newline is not part of the token
+    while (!contents.empty() && (contents.back() == '\n' || contents.back() == '\r')) {
+        contents.pop_back();
+    }
+    return TCL_OK;
+}
+
+static Aws::Auth::AWSCredentials
+aws_sdk_tcl_GetStsCredentials(const Aws::STS::Model::Credentials &credentials) {
+    return {
+            credentials.GetAccessKeyId(),
+            credentials.GetSecretAccessKey(),
+            credentials.GetSessionToken(),
+            credentials.GetExpiration()
+    };
+}
+
+typedef struct {
+    Aws::String provider;
+    Aws::String profile;
+    Aws::String role_arn;
+    Aws::String role_session_name;
+    Aws::String external_id;
+    Aws::String web_identity_token_file;
+    Tcl_WideInt duration_seconds;
+} aws_sdk_tcl_credentials_config_t;
+
+// The provider the role is assumed with, or that is used as it is when
+// no role is given.
+static int
+aws_sdk_tcl_GetBaseCredentialsProvider(Tcl_Interp *interp, const aws_sdk_tcl_credentials_config_t &config,
+                                       std::shared_ptr<Aws::Auth::AWSCredentialsProvider> &provider) {
+    if (config.provider == "default") {
+        provider = std::make_shared<Aws::Auth::DefaultAWSCredentialsProviderChain>();
+    } else if (config.provider == "environment") {
+        provider = std::make_shared<Aws::Auth::EnvironmentAWSCredentialsProvider>();
+    } else if (config.provider == "profile") {
+        provider = config.profile.empty()
+                   ? std::make_shared<Aws::Auth::ProfileConfigFileAWSCredentialsProvider>()
+                   : std::make_shared<Aws::Auth::ProfileConfigFileAWSCredentialsProvider>(config.profile.c_str());
+    } else if (config.provider == "instance") {
+        provider = std::make_shared<Aws::Auth::InstanceProfileCredentialsProvider>();
+    } else if (config.provider == "container") {
+        Aws::String relative_uri = Aws::Environment::GetEnv("AWS_CONTAINER_CREDENTIALS_RELATIVE_URI");
+        Aws::String full_uri = Aws::Environment::GetEnv("AWS_CONTAINER_CREDENTIALS_FULL_URI");
+        if (!relative_uri.empty()) {
+            provider = std::make_shared<Aws::Auth::TaskRoleCredentialsProvider>(relative_uri.c_str());
+        } else if (!full_uri.empty()) {
+            Aws::String token = Aws::Environment::GetEnv("AWS_CONTAINER_AUTHORIZATION_TOKEN");
+            provider = std::make_shared<Aws::Auth::TaskRoleCredentialsProvider>(full_uri.c_str(), token.c_str());
+        } else {
+            Tcl_SetObjResult(interp, Tcl_NewStringObj("credentials_provider container: neither"
+                " AWS_CONTAINER_CREDENTIALS_RELATIVE_URI nor AWS_CONTAINER_CREDENTIALS_FULL_URI is set", -1));
+            return TCL_ERROR;
+        }
+    } else if (config.provider == "web_identity") {
+        // the role and token file are taken from the environment or the profile
+        provider = std::make_shared<Aws::Auth::STSAssumeRoleWebIdentityCredentialsProvider>();
+    }
+    return TCL_OK;
+}
+
+// e.g. "AccessDenied: User ... is not authorized to perform sts:AssumeRole",
+// errors without a body have neither a name nor a message.
+static Aws::String
+aws_sdk_tcl_GetStsError(const Aws::Client::AWSError<Aws::STS::STSErrors> &error) {
+    Aws::String name = error.GetExceptionName();
+    if (name.empty()) {
+        name = error.GetResponseCode() == Aws::Http::HttpResponseCode::REQUEST_NOT_MADE
+               ? "NetworkError"
+               : Aws::String("HTTP ") + std::to_string((int) error.GetResponseCode()).c_str();
+    }
+    return error.GetMessage().empty() ? name : name + ": " + error.GetMessage();
+}
+
+static aws_sdk_tcl_RefreshingCredentialsProvider::fetch_fn_t
+aws_sdk_tcl_GetAssumeRoleFetchFn(const aws_sdk_tcl_credentials_config_t &config,
+                                 const Aws::Client::ClientConfiguration &clientConfig,
+                                 const std::shared_ptr<Aws::Auth::AWSCredentialsProvider> &base_provider) {
+    Aws::String session_name = config.role_session_name.empty() ? "aws-sdk-tcl" : config.role_session_name;
+
+    if (config.provider == "web_identity") {
+        // AssumeRoleWithWebIdentity is not signed, the token is the proof
+        auto sts_client = std::make_shared<Aws::STS::STSClient>(
+                std::make_shared<Aws::Auth::AnonymousAWSCredentialsProvider>(), clientConfig);
+        return [sts_client, config, session_name](Aws::String &error) -> Aws::Auth::AWSCredentials {
+            Aws::String token;
+            if (TCL_OK != aws_sdk_tcl_ReadFile(config.web_identity_token_file, token, error)) {
+                return {};
+            }
+            Aws::STS::Model::AssumeRoleWithWebIdentityRequest request;
+            request.SetRoleArn(config.role_arn);
+            request.SetRoleSessionName(session_name);
+            request.SetWebIdentityToken(token);
+            if (config.duration_seconds > 0) {
+                request.SetDurationSeconds((int) config.duration_seconds);
+            }
+            auto outcome = sts_client->AssumeRoleWithWebIdentity(request);
+            if (!outcome.IsSuccess()) {
+                error = aws_sdk_tcl_GetStsError(outcome.GetError());
+                return {};
+            }
+            return aws_sdk_tcl_GetStsCredentials(outcome.GetResult().GetCredentials());
+        };
+    }
+
+    auto sts_client = base_provider
+                      ? std::make_shared<Aws::STS::STSClient>(base_provider, clientConfig)
+                      : std::make_shared<Aws::STS::STSClient>(clientConfig);
+    return [sts_client, config, session_name](Aws::String &error) -> Aws::Auth::AWSCredentials {
+        Aws::STS::Model::AssumeRoleRequest request;
+        request.SetRoleArn(config.role_arn);
+        request.SetRoleSessionName(session_name);
+        if (!config.external_id.empty()) {
+            request.SetExternalId(config.external_id);
+        }
+        if (config.duration_seconds > 0) {
+            request.SetDurationSeconds((int) config.duration_seconds);
+        }
+        auto outcome = sts_client->AssumeRole(request);
+        if (!outcome.IsSuccess()) {
+            error = aws_sdk_tcl_GetStsError(outcome.GetError());
+            return {};
+        }
+        return aws_sdk_tcl_GetStsCredentials(outcome.GetResult().GetCredentials());
+    };
+}
+
+// Returns a shared refreshing provider for the credentials_provider,
+// profile and role_arn keys of the config dict, or leaves the provider
+// unset when none of them is given.
+static int
+aws_sdk_tcl_GetCredentialsProvider(Tcl_Interp *interp, Tcl_Obj *dict_ptr,
+                                   const Aws::Client::ClientConfiguration &clientConfig,
+                                   std::shared_ptr<Aws::Auth::AWSCredentialsProvider> static_provider,
+                                   std::shared_ptr<Aws::Auth::AWSCredentialsProvider> &provider) {
+    aws_sdk_tcl_credentials_config_t config;
+    Tcl_Obj *provider_name;
+    int duration_found;
+
+    if (TCL_OK != aws_sdk_tcl_DictGet(interp, dict_ptr, "credentials_provider", &provider_name)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "profile", config.profile)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "role_arn", config.role_arn)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "role_session_name", config.role_session_name)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "external_id", config.external_id)
+        || TCL_OK != aws_sdk_tcl_GetStringKey(interp, dict_ptr, "web_identity_token_file", config.web_identity_token_file)
+        || TCL_OK != aws_sdk_tcl_GetUnsignedKey(interp, dict_ptr, "role_duration_seconds", &config.duration_seconds, &duration_found)) {
+        return TCL_ERROR;
+    }
+    if (!duration_found) {
+        config.duration_seconds = 0;
+    }
+    if (provider_name) {
+        static const char *const providers[] = {
+                "default", "environment", "profile", "instance", "container", "web_identity", NULL
+        };
+        int index;
+        if (TCL_OK != Tcl_GetIndexFromObj(interp, provider_name, providers, "credentials_provider", 0, &index)) {
+            return TCL_ERROR;
+        }
+        config.provider = providers[index];
+    } else if (!config.profile.empty()) {
+        config.provider = "profile";
+    }
+    if (config.provider.empty() && config.role_arn.empty()) {
+        return TCL_OK;
+    }
+    if (config.provider == "web_identity" && config.role_arn.empty() != config.web_identity_token_file.empty()) {
+        Tcl_SetObjResult(interp, Tcl_NewStringObj("credentials_provider web_identity: role_arn and"
+            " web_identity_token_file have to be given together", -1));
+        return TCL_ERROR;
+    }
+
+    // the digest of the secret is part of the key so that different static
+    // credentials never share the role assumed with them
+    Aws::String key = config.provider + "\n" + config.profile + "\n" + config.role_arn + "\n"
+                      + config.role_session_name + "\n" + config.external_id + "\n"
+                      + config.web_identity_token_file + "\n" + std::to_string(config.duration_seconds).c_str() + "\n"
+                      + clientConfig.region + "\n" + clientConfig.endpointOverride;
+    if (static_provider && config.provider.empty()) {
+        Aws::Auth::AWSCredentials credentials = static_provider->GetAWSCredentials();
+        key.append("\n").append(credentials.GetAWSAccessKeyId())
+           .append("\n").append(aws_sdk_tcl_HashSecret(credentials.GetAWSSecretKey()))
+           .append("\n").append(aws_sdk_tcl_HashSecret(credentials.GetSessionToken()));
+    }
+
+    Tcl_MutexLock(&aws_sdk_tcl_CredentialsProvidersMutex);
+    std::shared_ptr<aws_sdk_tcl_RefreshingCredentialsProvider> shared = aws_sdk_tcl_CredentialsProviders[key].lock();
+    Tcl_MutexUnlock(&aws_sdk_tcl_CredentialsProvidersMutex);
+    if (shared) {
+        provider = shared;
+        return TCL_OK;
+    }
+
+    aws_sdk_tcl_RefreshingCredentialsProvider::fetch_fn_t fetch_fn;
+    if (config.role_arn.empty()) {
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> base_provider;
+        if (TCL_OK != aws_sdk_tcl_GetBaseCredentialsProvider(interp, config, base_provider)) {
+            return TCL_ERROR;
+        }
+        fetch_fn = [base_provider](Aws::String &) -> Aws::Auth::AWSCredentials {
+            return base_provider->GetAWSCredentials();
+        };
+    } else {
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> base_provider = static_provider;
+        if (config.provider != "web_identity" && !config.provider.empty()
+            && TCL_OK != aws_sdk_tcl_GetBaseCredentialsProvider(interp, config, base_provider)) {
+            return TCL_ERROR;
+        }
+        fetch_fn = aws_sdk_tcl_GetAssumeRoleFetchFn(config, clientConfig, base_provider);
+    }
+
+    // the first fetch happens here, so that a client never starts without credentials
+    shared = std::make_shared<aws_sdk_tcl_RefreshingCredentialsProvider>(fetch_fn);
+    if (shared->GetAWSCredentials().IsEmpty()) {
+        Aws::String error = shared->GetError();
+        Tcl_SetObjResult(interp, Tcl_ObjPrintf("could not get credentials: %s",
+                                               error.empty() ? "no credentials were returned" : error.c_str()));
+        return TCL_ERROR;
+    }
+
+    Tcl_MutexLock(&aws_sdk_tcl_CredentialsProvidersMutex);
+    std::weak_ptr<aws_sdk_tcl_RefreshingCredentialsProvider> &entry = aws_sdk_tcl_CredentialsProviders[key];
+    if (std::shared_ptr<aws_sdk_tcl_RefreshingCredentialsProvider> other = entry.lock()) {
+        // another thread created the same provider meanwhile
+        shared = other;
+    } else {
+        entry = shared;
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_CredentialsProvidersMutex);
+    provider = shared;
+    return TCL_OK;
+}
 
 std::tuple<int, Aws::Client::ClientConfiguration, std::shared_ptr<Aws::Auth::AWSCredentialsProvider>>
         get_client_config_and_credentials_provider(Tcl_Interp *interp, Tcl_Obj *const dict_ptr) {
@@ -49,6 +753,13 @@ std::tuple<int, Aws::Client::ClientConfiguration, std::shared_ptr<Aws::Auth::AWS
     if (endpoint) {
         clientConfig.endpointOverride = Tcl_GetString(endpoint);
     }
+    // every key is checked before the credentials are fetched
+    std::shared_ptr<Aws::Client::RetryStrategy> retry_strategy;
+    if (TCL_OK != aws_sdk_tcl_GetHttpConfig(interp, dict_ptr, clientConfig)
+        || TCL_OK != aws_sdk_tcl_GetExecutorConfig(interp, dict_ptr, clientConfig)
+        || TCL_OK != aws_sdk_tcl_GetRetryConfig(interp, dict_ptr, retry_strategy)) {
+        return {TCL_ERROR, clientConfig, nullptr};
+    }
     std::shared_ptr<Aws::Auth::AWSCredentialsProvider> credentials_provider_ptr = nullptr;
     if (aws_access_key_id && aws_secret_access_key) {
         Aws::Auth::AWSCredentials credentials = Aws::Auth::AWSCredentials(
@@ -59,10 +770,25 @@ std::tuple<int, Aws::Client::ClientConfiguration, std::shared_ptr<Aws::Auth::AWS
 
         credentials_provider_ptr = std::make_shared<Aws::Auth::SimpleAWSCredentialsProvider>(credentials);
     }
+    if (TCL_OK != aws_sdk_tcl_GetCredentialsProvider(interp, dict_ptr, clientConfig, credentials_provider_ptr, credentials_provider_ptr)) {
+        return {TCL_ERROR, clientConfig, nullptr};
+    }
+    // only set after the credentials, the STS client of a role keeps the SDK retries
+    if (retry_strategy) {
+        clientConfig.retryStrategy = retry_strategy;
+    }
     return {TCL_OK, clientConfig, credentials_provider_ptr};
 }
 
 
+int aws_sdk_tcl_DictGet(Tcl_Interp *interp, Tcl_Obj *dict_ptr, const char *key, Tcl_Obj **value_ptr) {
+    Tcl_Obj *key_ptr = Tcl_NewStringObj(key, -1);
+    Tcl_IncrRefCount(key_ptr);
+    int rc = Tcl_DictObjGet(interp, dict_ptr, key_ptr, value_ptr);
+    Tcl_DecrRefCount(key_ptr);
+    return rc;
+}
+
 char *aws_sdk_strndup(const char *s, size_t n) {
     if (s == NULL) {
         return NULL;
@@ -76,3 +802,949 @@ char *aws_sdk_strndup(const char *s, size_t n) {
     result[l] = '\0';
     return result;
 }
+
+typedef struct {
+    void *client;
+    void (*delete_fn)(void *client);
+    int refCount;
+} aws_sdk_tcl_shared_client_t;
+
+static Aws::Map<Aws::String, aws_sdk_tcl_shared_client_t> aws_sdk_tcl_SharedClients;
+static Aws::Map<void *, Aws::String> aws_sdk_tcl_SharedClientKeys;
+static Tcl_Mutex aws_sdk_tcl_SharedClientsMutex;
+static std::atomic<unsigned long> aws_sdk_tcl_SharedHandleId(0);
+
+// The key does not depend on the order of the keys in the config dict.
+int aws_sdk_tcl_GetSharedClientKey(Tcl_Interp *interp, const char *service, Tcl_Obj *dict_ptr, Aws::String &key) {
+    static const char *const secrets[] = { "aws_secret_access_key", "aws_session_token", "proxyPassword" };
+    Aws::Vector<std::pair<Aws::String, Aws::String>> entries;
+    Tcl_DictSearch search;
+    Tcl_Obj *k, *v;
+    int done;
+    if (TCL_OK != Tcl_DictObjFirst(interp, dict_ptr, &search, &k, &v, &done)) {
+        return TCL_ERROR;
+    }
+    for (; !done; Tcl_DictObjNext(&search, &k, &v, &done)) {
+        entries.emplace_back(Tcl_GetString(k), Tcl_GetString(v));
+        for (const char *secret: secrets) {
+            if (entries.back().first == secret) {
+                entries.back().second = aws_sdk_tcl_HashSecret(entries.back().second);
+            }
+        }
+    }
+    Tcl_DictObjDone(&search);
+    std::sort(entries.begin(), entries.end());
+
+    key = service;
+    for (const auto &entry: entries) {
+        key.append("\n").append(entry.first).append(" ").append(entry.second);
+    }
+    return TCL_OK;
+}
+
+void *aws_sdk_tcl_FindSharedClient(const Aws::String &key) {
+    void *client = nullptr;
+    Tcl_MutexLock(&aws_sdk_tcl_SharedClientsMutex);
+    auto it = aws_sdk_tcl_SharedClients.find(key);
+    if (it != aws_sdk_tcl_SharedClients.end()) {
+        it->second.refCount++;
+        client = it->second.client;
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_SharedClientsMutex);
+    return client;
+}
+
+// The client is created outside of the lock, when two threads create the
+// same one at the same time, the one that comes second is destroyed.
+void *aws_sdk_tcl_AddSharedClient(const Aws::String &key, void *client, void (*delete_fn)(void *client)) {
+    void *duplicate = nullptr;
+    Tcl_MutexLock(&aws_sdk_tcl_SharedClientsMutex);
+    auto it = aws_sdk_tcl_SharedClients.find(key);
+    if (it != aws_sdk_tcl_SharedClients.end()) {
+        it->second.refCount++;
+        duplicate = client;
+        client = it->second.client;
+    } else {
+        aws_sdk_tcl_SharedClients[key] = {client, delete_fn, 1};
+        aws_sdk_tcl_SharedClientKeys[client] = key;
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_SharedClientsMutex);
+    if (duplicate) {
+        delete_fn(duplicate);
+    }
+    return client;
+}
+
+unsigned long aws_sdk_tcl_NewSharedHandleId() {
+    return ++aws_sdk_tcl_SharedHandleId;
+}
+
+int aws_sdk_tcl_ReleaseSharedClient(void *client) {
+    int last = 1;
+    Tcl_MutexLock(&aws_sdk_tcl_SharedClientsMutex);
+    auto it = aws_sdk_tcl_SharedClientKeys.find(client);
+    if (it != aws_sdk_tcl_SharedClientKeys.end()) {
+        auto entry = aws_sdk_tcl_SharedClients.find(it->second);
+        if (--entry->second.refCount > 0) {
+            last = 0;
+        } else {
+            aws_sdk_tcl_SharedClients.erase(entry);
+            aws_sdk_tcl_SharedClientKeys.erase(it);
+        }
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_SharedClientsMutex);
+    return last;
+}
+
+// Destroys the pooled clients that are left, whatever their references,
+// once no module is loaded anymore.
+static void
+aws_sdk_tcl_DrainSharedClients() {
+    Aws::Vector<aws_sdk_tcl_shared_client_t> clients;
+    Tcl_MutexLock(&aws_sdk_tcl_SharedClientsMutex);
+    for (const auto &entry: aws_sdk_tcl_SharedClients) {
+        clients.push_back(entry.second);
+    }
+    aws_sdk_tcl_SharedClients.clear();
+    aws_sdk_tcl_SharedClientKeys.clear();
+    Tcl_MutexUnlock(&aws_sdk_tcl_SharedClientsMutex);
+    for (const auto &entry: clients) {
+        entry.delete_fn(entry.client);
+    }
+}
+
+struct aws_sdk_tcl_slot_s {
+    std::atomic<void *> item;
+    std::atomic<const void *> owner;
+    std::atomic<unsigned long> generation;
+    aws_sdk_tcl_slot_t *next_free;
+};
+
+typedef struct {
+    aws_sdk_tcl_slot_t *slot;
+    unsigned long generation;
+    // the name of the handle, its internal representation caches the slot
+    Tcl_Obj *handlePtr;
+} aws_sdk_tcl_handle_ref_t;
+
+static aws_sdk_tcl_slot_t *aws_sdk_tcl_FreeSlots = nullptr;
+static Tcl_Mutex aws_sdk_tcl_FreeSlotsMutex;
+
+static void
+aws_sdk_tcl_DupHandleInternalRep(Tcl_Obj *srcPtr, Tcl_Obj *dupPtr) {
+    dupPtr->internalRep.twoPtrValue.ptr1 = srcPtr->internalRep.twoPtrValue.ptr1;
+    dupPtr->internalRep.twoPtrValue.ptr2 = srcPtr->internalRep.twoPtrValue.ptr2;
+    dupPtr->typePtr = srcPtr->typePtr;
+}
+
+// ptr1 is the slot, ptr2 the generation of the slot when it was cached
+static Tcl_ObjType aws_sdk_tcl_HandleObjType = {
+    "aws-sdk-tcl-handle",
+    nullptr,
+    aws_sdk_tcl_DupHandleInternalRep,
+    nullptr,
+    nullptr
+};
+
+aws_sdk_tcl_slot_t *aws_sdk_tcl_AllocSlot(const void *owner, void *item) {
+    aws_sdk_tcl_slot_t *slot;
+    Tcl_MutexLock(&aws_sdk_tcl_FreeSlotsMutex);
+    slot = aws_sdk_tcl_FreeSlots;
+    if (slot != nullptr) {
+        aws_sdk_tcl_FreeSlots = slot->next_free;
+    } else {
+        slot = new aws_sdk_tcl_slot_t;
+        slot->generation = 0;
+    }
+    slot->next_free = nullptr;
+    slot->owner = owner;
+    slot->item = item;
+    Tcl_MutexUnlock(&aws_sdk_tcl_FreeSlotsMutex);
+    return slot;
+}
+
+void aws_sdk_tcl_FreeSlot(aws_sdk_tcl_slot_t *slot) {
+    Tcl_MutexLock(&aws_sdk_tcl_FreeSlotsMutex);
+    // invalidates the cached copies before the slot can be reused
+    slot->generation++;
+    slot->item = nullptr;
+    slot->owner = nullptr;
+    slot->next_free = aws_sdk_tcl_FreeSlots;
+    aws_sdk_tcl_FreeSlots = slot;
+    Tcl_MutexUnlock(&aws_sdk_tcl_FreeSlotsMutex);
+}
+
+void *aws_sdk_tcl_GetSlotItem(aws_sdk_tcl_slot_t *slot) {
+    return slot->item;
+}
+
+static void *
+aws_sdk_tcl_GetValidItem(aws_sdk_tcl_slot_t *slot, unsigned long generation, const void *owner) {
+    void *item = slot->item;
+    if (slot->owner != owner || slot->generation != generation) {
+        return nullptr;
+    }
+    return item;
+}
+
+void *aws_sdk_tcl_GetCachedItem(Tcl_Obj *objPtr, const void *owner) {
+    if (objPtr->typePtr != &aws_sdk_tcl_HandleObjType) {
+        return nullptr;
+    }
+    return aws_sdk_tcl_GetValidItem((aws_sdk_tcl_slot_t *) objPtr->internalRep.twoPtrValue.ptr1,
+                                    (unsigned long) (uintptr_t) objPtr->internalRep.twoPtrValue.ptr2,
+                                    owner);
+}
+
+static void
+aws_sdk_tcl_SetHandleInternalRep(Tcl_Obj *objPtr, aws_sdk_tcl_slot_t *slot, unsigned long generation) {
+    if (objPtr->typePtr != &aws_sdk_tcl_HandleObjType) {
+        // the string representation is all that is kept of the previous type
+        Tcl_GetString(objPtr);
+        if (objPtr->typePtr != nullptr && objPtr->typePtr->freeIntRepProc != nullptr) {
+            objPtr->typePtr->freeIntRepProc(objPtr);
+        }
+        objPtr->typePtr = &aws_sdk_tcl_HandleObjType;
+    }
+    objPtr->internalRep.twoPtrValue.ptr1 = slot;
+    objPtr->internalRep.twoPtrValue.ptr2 = (void *) (uintptr_t) generation;
+}
+
+// Called with the lock of the name table held, the slot cannot be freed meanwhile.
+void *aws_sdk_tcl_SetCachedItem(Tcl_Obj *objPtr, aws_sdk_tcl_slot_t *slot) {
+    aws_sdk_tcl_SetHandleInternalRep(objPtr, slot, slot->generation);
+    return slot->item;
+}
+
+// Called with the lock of the name table held, like aws_sdk_tcl_SetCachedItem,
+// in the thread of the interpreter of the handle command.
+ClientData aws_sdk_tcl_NewHandleRef(aws_sdk_tcl_slot_t *slot, const char *name) {
+    auto *ref = (aws_sdk_tcl_handle_ref_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_handle_ref_t));
+    ref->slot = slot;
+    ref->generation = slot->generation;
+    ref->handlePtr = Tcl_NewStringObj(name, -1);
+    Tcl_IncrRefCount(ref->handlePtr);
+    aws_sdk_tcl_SetHandleInternalRep(ref->handlePtr, slot, ref->generation);
+    return (ClientData) ref;
+}
+
+void aws_sdk_tcl_FreeHandleRef(ClientData clientData) {
+    auto *ref = (aws_sdk_tcl_handle_ref_t *) clientData;
+    Tcl_DecrRefCount(ref->handlePtr);
+    Tcl_Free((char *) ref);
+}
+
+aws_sdk_tcl_HandleObj::aws_sdk_tcl_HandleObj(ClientData clientData)
+        : objPtr(((aws_sdk_tcl_handle_ref_t *) clientData)->handlePtr) {
+    Tcl_IncrRefCount(objPtr);
+}
+
+aws_sdk_tcl_HandleObj::~aws_sdk_tcl_HandleObj() {
+    Tcl_DecrRefCount(objPtr);
+}
+
+// Log-linear latency buckets in microseconds: exact below 16us, then 8
+// buckets per power of two, i.e. a relative error of at most 12.5%.
+#define AWS_SDK_TCL_LATENCY_BUCKETS (16 + 8 * 36)
+
+static int
+aws_sdk_tcl_LatencyBucket(uint64_t us) {
+    if (us < 16) {
+        return (int) us;
+    }
+    int exponent = 63 - __builtin_clzll(us);
+    int bucket = 16 + (exponent - 4) * 8 + (int) ((us >> (exponent - 3)) & 7);
+    return std::min(bucket, AWS_SDK_TCL_LATENCY_BUCKETS - 1);
+}
+
+static uint64_t
+aws_sdk_tcl_LatencyBucketLimit(int bucket) {
+    if (bucket < 16) {
+        return (uint64_t) bucket;
+    }
+    int exponent = (bucket - 16) / 8 + 4;
+    uint64_t sub = (uint64_t) ((bucket - 16) % 8);
+    return ((8 + sub + 1) << (exponent - 3)) - 1;
+}
+
+// Counters of one operation as seen by one thread. Only that thread
+// updates them, the stats command reads and resets them concurrently.
+typedef struct {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> errors;
+    std::atomic<uint64_t> retries;
+    std::atomic<uint64_t> bytes_in;
+    std::atomic<uint64_t> bytes_out;
+    std::atomic<uint64_t> latency_sum_us;
+    std::atomic<uint64_t> latency[AWS_SDK_TCL_LATENCY_BUCKETS];
+} aws_sdk_tcl_op_stats_t;
+
+// The stats of a thread, keyed by service and operation. The owning thread
+// looks up its operations without locking, the mutex only orders the
+// insertion of a new operation against the readers. When its thread exits
+// a shard is folded into the retired stats, so that its counts are not lost
+// and that the threads started for single async requests leave nothing.
+typedef struct {
+    std::mutex mutex;
+    Aws::Map<std::pair<Aws::String, Aws::String>, aws_sdk_tcl_op_stats_t *> ops;
+} aws_sdk_tcl_stats_shard_t;
+
+static Aws::Vector<aws_sdk_tcl_stats_shard_t *> aws_sdk_tcl_StatsShards;
+// the shards of the threads that exited, guarded by aws_sdk_tcl_StatsShardsMutex
+static aws_sdk_tcl_stats_shard_t aws_sdk_tcl_RetiredStats;
+static Tcl_Mutex aws_sdk_tcl_StatsShardsMutex;
+
+static void
+aws_sdk_tcl_MoveCounter(std::atomic<uint64_t> &to, std::atomic<uint64_t> &from) {
+    to.fetch_add(from.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+static void
+aws_sdk_tcl_RetireStatsShard(aws_sdk_tcl_stats_shard_t *shard) {
+    Tcl_MutexLock(&aws_sdk_tcl_StatsShardsMutex);
+    aws_sdk_tcl_StatsShards.erase(
+            std::find(aws_sdk_tcl_StatsShards.begin(), aws_sdk_tcl_StatsShards.end(), shard));
+    for (auto &op: shard->ops) {
+        aws_sdk_tcl_op_stats_t *&retired = aws_sdk_tcl_RetiredStats.ops[op.first];
+        if (retired == nullptr) {
+            retired = new aws_sdk_tcl_op_stats_t();
+        }
+        aws_sdk_tcl_op_stats_t *stats = op.second;
+        aws_sdk_tcl_MoveCounter(retired->count, stats->count);
+        aws_sdk_tcl_MoveCounter(retired->errors, stats->errors);
+        aws_sdk_tcl_MoveCounter(retired->retries, stats->retries);
+        aws_sdk_tcl_MoveCounter(retired->bytes_in, stats->bytes_in);
+        aws_sdk_tcl_MoveCounter(retired->bytes_out, stats->bytes_out);
+        aws_sdk_tcl_MoveCounter(retired->latency_sum_us, stats->latency_sum_us);
+        for (int i = 0; i < AWS_SDK_TCL_LATENCY_BUCKETS; i++) {
+            aws_sdk_tcl_MoveCounter(retired->latency[i], stats->latency[i]);
+        }
+        delete stats;
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_StatsShardsMutex);
+    delete shard;
+}
+
+// The shard of the current thread, retired by its destructor at thread exit.
+class aws_sdk_tcl_StatsShardOwner {
+public:
+    ~aws_sdk_tcl_StatsShardOwner() {
+        if (shard != nullptr) {
+            aws_sdk_tcl_RetireStatsShard(shard);
+        }
+    }
+    aws_sdk_tcl_stats_shard_t *shard = nullptr;
+};
+
+static aws_sdk_tcl_op_stats_t *
+aws_sdk_tcl_GetOpStats(const Aws::String &service, const Aws::String &operation) {
+    static thread_local aws_sdk_tcl_StatsShardOwner owner;
+    aws_sdk_tcl_stats_shard_t *shard = owner.shard;
+    if (shard == nullptr) {
+        shard = owner.shard = new aws_sdk_tcl_stats_shard_t;
+        Tcl_MutexLock(&aws_sdk_tcl_StatsShardsMutex);
+        aws_sdk_tcl_StatsShards.push_back(shard);
+        Tcl_MutexUnlock(&aws_sdk_tcl_StatsShardsMutex);
+    }
+    auto key = std::make_pair(service, operation);
+    auto it = shard->ops.find(key);
+    if (it != shard->ops.end()) {
+        return it->second;
+    }
+    auto *stats = new aws_sdk_tcl_op_stats_t();
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->ops[key] = stats;
+    return stats;
+}
+
+static uint64_t
+aws_sdk_tcl_GetRequestLength(const std::shared_ptr<const Aws::Http::HttpRequest> &request) {
+    return request->HasContentLength() ? (uint64_t) strtoull(request->GetContentLength().c_str(), nullptr, 10) : 0;
+}
+
+static uint64_t
+aws_sdk_tcl_GetResponseLength(const Aws::Client::HttpResponseOutcome &outcome) {
+    const std::shared_ptr<Aws::Http::HttpResponse> &response = outcome.GetResult();
+    if (!response || !response->HasHeader("content-length")) {
+        return 0;
+    }
+    return (uint64_t) strtoull(response->GetHeader("content-length").c_str(), nullptr, 10);
+}
+
+typedef struct {
+    std::chrono::steady_clock::time_point start;
+    bool failed;
+} aws_sdk_tcl_stats_context_t;
+
+// Registered with the SDK at initialization, sees every request of every
+// client. The context of a request spans all of its attempts.
+class aws_sdk_tcl_StatsMonitoring : public Aws::Monitoring::MonitoringInterface {
+public:
+    void *OnRequestStarted(const Aws::String &, const Aws::String &,
+                           const std::shared_ptr<const Aws::Http::HttpRequest> &) const override {
+        return new aws_sdk_tcl_stats_context_t{std::chrono::steady_clock::now(), false};
+    }
+
+    void OnRequestSucceeded(const Aws::String &serviceName, const Aws::String &requestName,
+                            const std::shared_ptr<const Aws::Http::HttpRequest> &request,
+                            const Aws::Client::HttpResponseOutcome &outcome,
+                            const Aws::Monitoring::CoreMetricsCollection &, void *context) const override {
+        aws_sdk_tcl_op_stats_t *stats = aws_sdk_tcl_GetOpStats(serviceName, requestName);
+        stats->bytes_out.fetch_add(aws_sdk_tcl_GetRequestLength(request), std::memory_order_relaxed);
+        stats->bytes_in.fetch_add(aws_sdk_tcl_GetResponseLength(outcome), std::memory_order_relaxed);
+        ((aws_sdk_tcl_stats_context_t *) context)->failed = false;
+    }
+
+    void OnRequestFailed(const Aws::String &serviceName, const Aws::String &requestName,
+                         const std::shared_ptr<const Aws::Http::HttpRequest> &request,
+                         const Aws::Client::HttpResponseOutcome &,
+                         const Aws::Monitoring::CoreMetricsCollection &, void *context) const override {
+        aws_sdk_tcl_op_stats_t *stats = aws_sdk_tcl_GetOpStats(serviceName, requestName);
+        stats->bytes_out.fetch_add(aws_sdk_tcl_GetRequestLength(request), std::memory_order_relaxed);
+        ((aws_sdk_tcl_stats_context_t *) context)->failed = true;
+    }
+
+    void OnRequestRetry(const Aws::String &serviceName, const Aws::String &requestName,
+                        const std::shared_ptr<const Aws::Http::HttpRequest> &, void *) const override {
+        aws_sdk_tcl_GetOpStats(serviceName, requestName)->retries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void OnFinish(const Aws::String &serviceName, const Aws::String &requestName,
+                  const std::shared_ptr<const Aws::Http::HttpRequest> &, void *context) const override {
+        auto *ctx = (aws_sdk_tcl_stats_context_t *) context;
+        auto us = (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - ctx->start).count();
+        aws_sdk_tcl_op_stats_t *stats = aws_sdk_tcl_GetOpStats(serviceName, requestName);
+        stats->count.fetch_add(1, std::memory_order_relaxed);
+        if (ctx->failed) {
+            stats->errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        stats->latency_sum_us.fetch_add(us, std::memory_order_relaxed);
+        stats->latency[aws_sdk_tcl_LatencyBucket(us)].fetch_add(1, std::memory_order_relaxed);
+        delete ctx;
+    }
+};
+
+class aws_sdk_tcl_StatsMonitoringFactory : public Aws::Monitoring::MonitoringFactory {
+public:
+    Aws::UniquePtr<Aws::Monitoring::MonitoringInterface> CreateMonitoringInstance() const override {
+        return Aws::MakeUnique<aws_sdk_tcl_StatsMonitoring>("aws-sdk-tcl");
+    }
+};
+
+typedef struct {
+    uint64_t count, errors, retries, bytes_in, bytes_out, latency_sum_us;
+    uint64_t latency[AWS_SDK_TCL_LATENCY_BUCKETS];
+} aws_sdk_tcl_op_totals_t;
+
+static uint64_t
+aws_sdk_tcl_ReadCounter(std::atomic<uint64_t> &counter, int reset) {
+    return reset ? counter.exchange(0, std::memory_order_relaxed) : counter.load(std::memory_order_relaxed);
+}
+
+static uint64_t
+aws_sdk_tcl_LatencyPercentile(const aws_sdk_tcl_op_totals_t &totals, uint64_t samples, double percentile) {
+    uint64_t rank = (uint64_t) std::ceil(percentile / 100.0 * (double) samples);
+    uint64_t seen = 0;
+    for (int i = 0; i < AWS_SDK_TCL_LATENCY_BUCKETS; i++) {
+        seen += totals.latency[i];
+        if (seen >= rank && seen > 0) {
+            return aws_sdk_tcl_LatencyBucketLimit(i);
+        }
+    }
+    return 0;
+}
+
+static Tcl_Obj *
+aws_sdk_tcl_NewOpStatsObj(const aws_sdk_tcl_op_totals_t &totals) {
+    Tcl_Obj *dictPtr = Tcl_NewDictObj();
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("count", -1), Tcl_NewWideIntObj((Tcl_WideInt) totals.count));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("errors", -1), Tcl_NewWideIntObj((Tcl_WideInt) totals.errors));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("retries", -1), Tcl_NewWideIntObj((Tcl_WideInt) totals.retries));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("bytes_in", -1), Tcl_NewWideIntObj((Tcl_WideInt) totals.bytes_in));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("bytes_out", -1), Tcl_NewWideIntObj((Tcl_WideInt) totals.bytes_out));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("latency_sum_us", -1), Tcl_NewWideIntObj((Tcl_WideInt) totals.latency_sum_us));
+
+    // the samples are counted from the buckets, a reset may race with a request
+    uint64_t samples = 0;
+    Tcl_Obj *bucketsPtr = Tcl_NewListObj(0, nullptr);
+    for (int i = 0; i < AWS_SDK_TCL_LATENCY_BUCKETS; i++) {
+        if (totals.latency[i] > 0) {
+            samples += totals.latency[i];
+            // cumulative like the buckets of a Prometheus histogram
+            Tcl_ListObjAppendElement(nullptr, bucketsPtr, Tcl_NewWideIntObj((Tcl_WideInt) aws_sdk_tcl_LatencyBucketLimit(i)));
+            Tcl_ListObjAppendElement(nullptr, bucketsPtr, Tcl_NewWideIntObj((Tcl_WideInt) samples));
+        }
+    }
+    static const double percentiles[] = { 50, 90, 99, 99.9 };
+    static const char *const names[] = { "p50_us", "p90_us", "p99_us", "p999_us" };
+    for (int i = 0; i < 4; i++) {
+        Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj(names[i], -1),
+                       Tcl_NewWideIntObj((Tcl_WideInt) aws_sdk_tcl_LatencyPercentile(totals, samples, percentiles[i])));
+    }
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("max_us", -1),
+                   Tcl_NewWideIntObj((Tcl_WideInt) aws_sdk_tcl_LatencyPercentile(totals, samples, 100)));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("latency_buckets_us", -1), bucketsPtr);
+    return dictPtr;
+}
+
+static void
+aws_sdk_tcl_AddShardTotals(aws_sdk_tcl_stats_shard_t *shard, int reset,
+                           Aws::Map<std::pair<Aws::String, Aws::String>, aws_sdk_tcl_op_totals_t> &totals) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto &op: shard->ops) {
+        auto it = totals.find(op.first);
+        if (it == totals.end()) {
+            it = totals.emplace(op.first, aws_sdk_tcl_op_totals_t()).first;
+        }
+        aws_sdk_tcl_op_totals_t &total = it->second;
+        aws_sdk_tcl_op_stats_t *stats = op.second;
+        total.count += aws_sdk_tcl_ReadCounter(stats->count, reset);
+        total.errors += aws_sdk_tcl_ReadCounter(stats->errors, reset);
+        total.retries += aws_sdk_tcl_ReadCounter(stats->retries, reset);
+        total.bytes_in += aws_sdk_tcl_ReadCounter(stats->bytes_in, reset);
+        total.bytes_out += aws_sdk_tcl_ReadCounter(stats->bytes_out, reset);
+        total.latency_sum_us += aws_sdk_tcl_ReadCounter(stats->latency_sum_us, reset);
+        for (int i = 0; i < AWS_SDK_TCL_LATENCY_BUCKETS; i++) {
+            total.latency[i] += aws_sdk_tcl_ReadCounter(stats->latency[i], reset);
+        }
+    }
+}
+
+static int
+aws_sdk_tcl_StatsObjCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    int reset = 0;
+    if (objc == 2 && 0 == strcmp(Tcl_GetString(objv[1]), "-reset")) {
+        reset = 1;
+    } else if (objc != 1) {
+        Tcl_WrongNumArgs(interp, 1, objv, "?-reset?");
+        return TCL_ERROR;
+    }
+
+    Aws::Map<std::pair<Aws::String, Aws::String>, aws_sdk_tcl_op_totals_t> totals;
+    Tcl_MutexLock(&aws_sdk_tcl_StatsShardsMutex);
+    for (aws_sdk_tcl_stats_shard_t *shard: aws_sdk_tcl_StatsShards) {
+        aws_sdk_tcl_AddShardTotals(shard, reset, totals);
+    }
+    aws_sdk_tcl_AddShardTotals(&aws_sdk_tcl_RetiredStats, reset, totals);
+    Tcl_MutexUnlock(&aws_sdk_tcl_StatsShardsMutex);
+
+    Tcl_Obj *resultPtr = Tcl_NewDictObj();
+    for (const auto &op: totals) {
+        Tcl_Obj *keys[2] = {
+                Tcl_NewStringObj(op.first.first.c_str(), -1),
+                Tcl_NewStringObj(op.first.second.c_str(), -1)
+        };
+        Tcl_DictObjPutKeyList(interp, resultPtr, 2, keys, aws_sdk_tcl_NewOpStatsObj(op.second));
+    }
+    Tcl_SetObjResult(interp, resultPtr);
+    return TCL_OK;
+}
+
+// A finished request as a span: ids in the OpenTelemetry format, wall
+// clock start and end, the outcome of the last attempt and the timings the
+// HTTP client measured for it (for curl: DnsLatency, ConnectLatency,
+// SslLatency and so on, in milliseconds).
+typedef struct {
+    char trace_id[33];
+    char span_id[17];
+    Aws::String service;
+    Aws::String operation;
+    int64_t start_ns;
+    int64_t end_ns;
+    long retries;
+    int http_status;
+    bool failed;
+    Aws::String error;
+    Aws::String request_id;
+    Aws::Monitoring::HttpClientMetricsCollection http_metrics;
+} aws_sdk_tcl_span_t;
+
+// Spans are kept in a ring until they are flushed, the oldest ones are
+// overwritten and counted as dropped when nobody flushes in time.
+static std::atomic<bool> aws_sdk_tcl_TraceEnabled(false);
+static Aws::Vector<aws_sdk_tcl_span_t> aws_sdk_tcl_TraceRing;
+static size_t aws_sdk_tcl_TraceHead = 0;
+static size_t aws_sdk_tcl_TraceCount = 0;
+static uint64_t aws_sdk_tcl_TraceDropped = 0;
+static std::mutex aws_sdk_tcl_TraceMutex;
+
+static int64_t
+aws_sdk_tcl_NowNs() {
+    return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static void
+aws_sdk_tcl_RandomHex(char *buffer, int length) {
+    static thread_local std::mt19937_64 generator(std::random_device{}());
+    static const char digits[] = "0123456789abcdef";
+    for (int i = 0; i < length; i++) {
+        buffer[i] = digits[generator() & 15];
+    }
+    buffer[length] = '\0';
+}
+
+static void
+aws_sdk_tcl_TraceOutcome(aws_sdk_tcl_span_t *span, const Aws::Client::HttpResponseOutcome &outcome,
+                         const Aws::Monitoring::CoreMetricsCollection &metrics) {
+    span->http_metrics = metrics.httpClientMetrics;
+    if (outcome.IsSuccess()) {
+        const std::shared_ptr<Aws::Http::HttpResponse> &response = outcome.GetResult();
+        span->failed = false;
+        span->error.clear();
+        span->http_status = (int) response->GetResponseCode();
+        span->request_id = response->HasHeader("x-amz-request-id") ? response->GetHeader("x-amz-request-id")
+                           : response->HasHeader("x-amzn-requestid") ? response->GetHeader("x-amzn-requestid") : "";
+    } else {
+        span->failed = true;
+        span->error = outcome.GetError().GetExceptionName();
+        span->http_status = (int) outcome.GetError().GetResponseCode();
+        span->request_id = outcome.GetError().GetRequestId();
+    }
+}
+
+class aws_sdk_tcl_TraceMonitoring : public Aws::Monitoring::MonitoringInterface {
+public:
+    void *OnRequestStarted(const Aws::String &serviceName, const Aws::String &requestName,
+                           const std::shared_ptr<const Aws::Http::HttpRequest> &) const override {
+        if (!aws_sdk_tcl_TraceEnabled.load(std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        auto *span = new aws_sdk_tcl_span_t();
+        aws_sdk_tcl_RandomHex(span->trace_id, 32);
+        aws_sdk_tcl_RandomHex(span->span_id, 16);
+        span->service = serviceName;
+        span->operation = requestName;
+        span->start_ns = aws_sdk_tcl_NowNs();
+        return span;
+    }
+
+    void OnRequestSucceeded(const Aws::String &, const Aws::String &, const std::shared_ptr<const Aws::Http::HttpRequest> &,
+                            const Aws::Client::HttpResponseOutcome &outcome,
+                            const Aws::Monitoring::CoreMetricsCollection &metrics, void *context) const override {
+        if (context != nullptr) {
+            aws_sdk_tcl_TraceOutcome((aws_sdk_tcl_span_t *) context, outcome, metrics);
+        }
+    }
+
+    void OnRequestFailed(const Aws::String &, const Aws::String &, const std::shared_ptr<const Aws::Http::HttpRequest> &,
+                         const Aws::Client::HttpResponseOutcome &outcome,
+                         const Aws::Monitoring::CoreMetricsCollection &metrics, void *context) const override {
+        if (context != nullptr) {
+            aws_sdk_tcl_TraceOutcome((aws_sdk_tcl_span_t *) context, outcome, metrics);
+        }
+    }
+
+    void OnRequestRetry(const Aws::String &, const Aws::String &, const std::shared_ptr<const Aws::Http::HttpRequest> &,
+                        void *context) const override {
+        if (context != nullptr) {
+            ((aws_sdk_tcl_span_t *) context)->retries++;
+        }
+    }
+
+    void OnFinish(const Aws::String &, const Aws::String &, const std::shared_ptr<const Aws::Http::HttpRequest> &,
+                  void *context) const override {
+        if (context == nullptr) {
+            return;
+        }
+        auto *span = (aws_sdk_tcl_span_t *) context;
+        span->end_ns = aws_sdk_tcl_NowNs();
+        {
+            std::lock_guard<std::mutex> lock(aws_sdk_tcl_TraceMutex);
+            if (!aws_sdk_tcl_TraceRing.empty()) {
+                size_t size = aws_sdk_tcl_TraceRing.size();
+                aws_sdk_tcl_TraceRing[(aws_sdk_tcl_TraceHead + aws_sdk_tcl_TraceCount) % size] = std::move(*span);
+                if (aws_sdk_tcl_TraceCount < size) {
+                    aws_sdk_tcl_TraceCount++;
+                } else {
+                    aws_sdk_tcl_TraceHead = (aws_sdk_tcl_TraceHead + 1) % size;
+                    aws_sdk_tcl_TraceDropped++;
+                }
+            }
+        }
+        delete span;
+    }
+};
+
+class aws_sdk_tcl_TraceMonitoringFactory : public Aws::Monitoring::MonitoringFactory {
+public:
+    Aws::UniquePtr<Aws::Monitoring::MonitoringInterface> CreateMonitoringInstance() const override {
+        return Aws::MakeUnique<aws_sdk_tcl_TraceMonitoring>("aws-sdk-tcl");
+    }
+};
+
+static Tcl_Obj *
+aws_sdk_tcl_NewSpanObj(const aws_sdk_tcl_span_t &span) {
+    Tcl_Obj *dictPtr = Tcl_NewDictObj();
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("trace_id", -1), Tcl_NewStringObj(span.trace_id, -1));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("span_id", -1), Tcl_NewStringObj(span.span_id, -1));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("name", -1),
+                   Tcl_ObjPrintf("%s.%s", span.service.c_str(), span.operation.c_str()));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("service", -1), Tcl_NewStringObj(span.service.c_str(), -1));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("operation", -1), Tcl_NewStringObj(span.operation.c_str(), -1));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("start_time_unix_nano", -1), Tcl_NewWideIntObj(span.start_ns));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("end_time_unix_nano", -1), Tcl_NewWideIntObj(span.end_ns));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("status", -1), Tcl_NewStringObj(span.failed ? "error" : "ok", -1));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("error", -1), Tcl_NewStringObj(span.error.c_str(), -1));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("http_status", -1), Tcl_NewIntObj(span.http_status));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("request_id", -1), Tcl_NewStringObj(span.request_id.c_str(), -1));
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("retries", -1), Tcl_NewWideIntObj(span.retries));
+    Tcl_Obj *metricsPtr = Tcl_NewDictObj();
+    for (const auto &metric: span.http_metrics) {
+        Tcl_DictObjPut(nullptr, metricsPtr, Tcl_NewStringObj(metric.first.c_str(), -1), Tcl_NewWideIntObj(metric.second));
+    }
+    Tcl_DictObjPut(nullptr, dictPtr, Tcl_NewStringObj("http_metrics", -1), metricsPtr);
+    return dictPtr;
+}
+
+// Removes up to max_spans spans from the ring, oldest first.
+static Tcl_Obj *
+aws_sdk_tcl_FlushSpans(size_t max_spans) {
+    Aws::Vector<aws_sdk_tcl_span_t> spans;
+    {
+        std::lock_guard<std::mutex> lock(aws_sdk_tcl_TraceMutex);
+        size_t n = std::min(max_spans, aws_sdk_tcl_TraceCount);
+        spans.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            spans.push_back(std::move(aws_sdk_tcl_TraceRing[aws_sdk_tcl_TraceHead]));
+            aws_sdk_tcl_TraceHead = (aws_sdk_tcl_TraceHead + 1) % aws_sdk_tcl_TraceRing.size();
+        }
+        aws_sdk_tcl_TraceCount -= n;
+    }
+    // the dicts are built outside of the lock
+    Tcl_Obj *listPtr = Tcl_NewListObj(0, nullptr);
+    for (const auto &span: spans) {
+        Tcl_ListObjAppendElement(nullptr, listPtr, aws_sdk_tcl_NewSpanObj(span));
+    }
+    return listPtr;
+}
+
+// A handler flushes the ring on a timer of the thread of its interpreter
+// and passes every batch to its command.
+typedef struct {
+    Tcl_Interp *interp;
+    Tcl_Obj *cmdPtr;
+    int interval_ms;
+    int batch_size;
+    Tcl_TimerToken timer;
+} aws_sdk_tcl_trace_handler_t;
+
+#define AWS_SDK_TCL_TRACE_HANDLER "aws-sdk-tcl-trace-handler"
+
+static void
+aws_sdk_tcl_TraceTimerProc(ClientData clientData) {
+    auto *handler = (aws_sdk_tcl_trace_handler_t *) clientData;
+    Tcl_Interp *interp = handler->interp;
+    Tcl_Obj *cmdPtr = handler->cmdPtr;
+    Tcl_IncrRefCount(cmdPtr);
+    // the command may replace or remove the handler, which is then freed
+    // only once this call is over
+    Tcl_Preserve(handler);
+    Tcl_Preserve(interp);
+    int rc = TCL_OK;
+    for (;;) {
+        Tcl_Obj *spansPtr = aws_sdk_tcl_FlushSpans((size_t) handler->batch_size);
+        Tcl_Size n;
+        Tcl_ListObjLength(nullptr, spansPtr, &n);
+        if (n == 0) {
+            Tcl_DecrRefCount(spansPtr);
+            break;
+        }
+        Tcl_Obj *evalPtr = Tcl_DuplicateObj(cmdPtr);
+        Tcl_IncrRefCount(evalPtr);
+        Tcl_ListObjAppendElement(interp, evalPtr, spansPtr);
+        rc = Tcl_EvalObjEx(interp, evalPtr, TCL_EVAL_GLOBAL);
+        Tcl_DecrRefCount(evalPtr);
+        if (rc != TCL_OK || handler->cmdPtr == nullptr || n < (Tcl_Size) handler->batch_size) {
+            break;
+        }
+    }
+    if (rc != TCL_OK && rc != TCL_BREAK) {
+        Tcl_BackgroundException(interp, rc);
+    }
+    Tcl_DecrRefCount(cmdPtr);
+    // a handler that has been replaced or removed has no command anymore
+    if (handler->cmdPtr != nullptr) {
+        handler->timer = Tcl_CreateTimerHandler(handler->interval_ms, aws_sdk_tcl_TraceTimerProc, handler);
+    }
+    Tcl_Release(interp);
+    Tcl_Release(handler);
+}
+
+static void
+aws_sdk_tcl_FreeTraceHandler(ClientData clientData, Tcl_Interp *) {
+    auto *handler = (aws_sdk_tcl_trace_handler_t *) clientData;
+    Tcl_DeleteTimerHandler(handler->timer);
+    Tcl_DecrRefCount(handler->cmdPtr);
+    handler->cmdPtr = nullptr;
+    Tcl_EventuallyFree(handler, TCL_DYNAMIC);
+}
+
+static int
+aws_sdk_tcl_TraceObjCmd(ClientData clientData, Tcl_Interp *interp, int objc, Tcl_Obj *const objv[]) {
+    static const char *const subcommands[] = { "start", "stop", "flush", "handler", "info", NULL };
+    enum subcommands { SUB_START, SUB_STOP, SUB_FLUSH, SUB_HANDLER, SUB_INFO };
+    int sub;
+
+    if (objc < 2) {
+        Tcl_WrongNumArgs(interp, 1, objv, "start|stop|flush|handler|info ?arg ...?");
+        return TCL_ERROR;
+    }
+    if (TCL_OK != Tcl_GetIndexFromObj(interp, objv[1], subcommands, "subcommand", 0, &sub)) {
+        return TCL_ERROR;
+    }
+    switch ((enum subcommands) sub) {
+        case SUB_START: {
+            int size = 4096;
+            if (objc == 4 && 0 == strcmp(Tcl_GetString(objv[2]), "-buffer-size")) {
+                if (TCL_OK != Tcl_GetIntFromObj(interp, objv[3], &size)) {
+                    return TCL_ERROR;
+                }
+                if (size <= 0) {
+                    Tcl_SetObjResult(interp, Tcl_NewStringObj("-buffer-size: positive integer expected", -1));
+                    return TCL_ERROR;
+                }
+            } else if (objc != 2) {
+                Tcl_WrongNumArgs(interp, 2, objv, "?-buffer-size n?");
+                return TCL_ERROR;
+            }
+            std::lock_guard<std::mutex> lock(aws_sdk_tcl_TraceMutex);
+            // the buffered spans are dropped when the ring is resized
+            if (aws_sdk_tcl_TraceRing.size() != (size_t) size) {
+                aws_sdk_tcl_TraceRing.clear();
+                aws_sdk_tcl_TraceRing.resize((size_t) size);
+                aws_sdk_tcl_TraceHead = 0;
+                aws_sdk_tcl_TraceCount = 0;
+            }
+            aws_sdk_tcl_TraceEnabled = true;
+            return TCL_OK;
+        }
+        case SUB_STOP:
+            if (objc != 2) {
+                Tcl_WrongNumArgs(interp, 2, objv, nullptr);
+                return TCL_ERROR;
+            }
+            // the spans of the requests in flight are still recorded
+            aws_sdk_tcl_TraceEnabled = false;
+            return TCL_OK;
+        case SUB_FLUSH: {
+            int max_spans = INT_MAX;
+            if (objc == 3) {
+                if (TCL_OK != Tcl_GetIntFromObj(interp, objv[2], &max_spans)) {
+                    return TCL_ERROR;
+                }
+            } else if (objc != 2) {
+                Tcl_WrongNumArgs(interp, 2, objv, "?max_spans?");
+                return TCL_ERROR;
+            }
+            Tcl_SetObjResult(interp, aws_sdk_tcl_FlushSpans((size_t) std::max(max_spans, 0)));
+            return TCL_OK;
+        }
+        case SUB_HANDLER: {
+            int interval_ms = 1000;
+            int batch_size = 100;
+            if (objc < 3 || objc % 2 == 0) {
+                Tcl_WrongNumArgs(interp, 2, objv, "cmd ?-interval ms? ?-batch-size n?");
+                return TCL_ERROR;
+            }
+            for (int i = 3; i < objc; i += 2) {
+                static const char *const options[] = { "-interval", "-batch-size", NULL };
+                int option, value;
+                if (TCL_OK != Tcl_GetIndexFromObj(interp, objv[i], options, "option", 0, &option)
+                    || TCL_OK != Tcl_GetIntFromObj(interp, objv[i + 1], &value)) {
+                    return TCL_ERROR;
+                }
+                if (value <= 0) {
+                    Tcl_SetObjResult(interp, Tcl_ObjPrintf("%s: positive integer expected", options[option]));
+                    return TCL_ERROR;
+                }
+                if (option == 0) {
+                    interval_ms = value;
+                } else {
+                    batch_size = value;
+                }
+            }
+            // an empty command removes the handler of the interpreter
+            Tcl_DeleteAssocData(interp, AWS_SDK_TCL_TRACE_HANDLER);
+            Tcl_Size length;
+            Tcl_GetStringFromObj(objv[2], &length);
+            if (length > 0) {
+                auto *handler = (aws_sdk_tcl_trace_handler_t *) Tcl_Alloc(sizeof(aws_sdk_tcl_trace_handler_t));
+                handler->interp = interp;
+                handler->cmdPtr = objv[2];
+                Tcl_IncrRefCount(handler->cmdPtr);
+                handler->interval_ms = interval_ms;
+                handler->batch_size = batch_size;
+                handler->timer = Tcl_CreateTimerHandler(interval_ms, aws_sdk_tcl_TraceTimerProc, handler);
+                Tcl_SetAssocData(interp, AWS_SDK_TCL_TRACE_HANDLER, aws_sdk_tcl_FreeTraceHandler, handler);
+            }
+            return TCL_OK;
+        }
+        case SUB_INFO: {
+            if (objc != 2) {
+                Tcl_WrongNumArgs(interp, 2, objv, nullptr);
+                return TCL_ERROR;
+            }
+            Tcl_Obj *dictPtr = Tcl_NewDictObj();
+            std::lock_guard<std::mutex> lock(aws_sdk_tcl_TraceMutex);
+            Tcl_DictObjPut(interp, dictPtr, Tcl_NewStringObj("enabled", -1), Tcl_NewBooleanObj(aws_sdk_tcl_TraceEnabled.load()));
+            Tcl_DictObjPut(interp, dictPtr, Tcl_NewStringObj("buffer_size", -1), Tcl_NewWideIntObj((Tcl_WideInt) aws_sdk_tcl_TraceRing.size()));
+            Tcl_DictObjPut(interp, dictPtr, Tcl_NewStringObj("buffered", -1), Tcl_NewWideIntObj((Tcl_WideInt) aws_sdk_tcl_TraceCount));
+            Tcl_DictObjPut(interp, dictPtr, Tcl_NewStringObj("dropped", -1), Tcl_NewWideIntObj((Tcl_WideInt) aws_sdk_tcl_TraceDropped));
+            Tcl_SetObjResult(interp, dictPtr);
+            return TCL_OK;
+        }
+    }
+    return TCL_OK;
+}
+
+void aws_sdk_tcl_CreateCommonCmds(Tcl_Interp *interp) {
+    Tcl_CreateObjCommand(interp, "::aws::stats", aws_sdk_tcl_StatsObjCmd, nullptr, nullptr);
+    Tcl_CreateObjCommand(interp, "::aws::trace", aws_sdk_tcl_TraceObjCmd, nullptr, nullptr);
+}
+
+void aws_sdk_tcl_InitAPI() {
+    Tcl_MutexLock(&aws_sdk_tcl_InitMutex);
+    if (aws_sdk_tcl_InitCount++ == 0) {
+        aws_sdk_tcl_options.monitoringOptions.customizedMonitoringFactory_create_fn = {
+                [] {
+                    return Aws::UniquePtr<Aws::Monitoring::MonitoringFactory>(
+                            Aws::New<aws_sdk_tcl_StatsMonitoringFactory>("aws-sdk-tcl"));
+                },
+                [] {
+                    return Aws::UniquePtr<Aws::Monitoring::MonitoringFactory>(
+                            Aws::New<aws_sdk_tcl_TraceMonitoringFactory>("aws-sdk-tcl"));
+                }
+        };
+        Aws::InitAPI(aws_sdk_tcl_options);
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_InitMutex);
+}
+
+void aws_sdk_tcl_ShutdownAPI() {
+    Tcl_MutexLock(&aws_sdk_tcl_InitMutex);
+    if (aws_sdk_tcl_InitCount > 0 && --aws_sdk_tcl_InitCount == 0) {
+        // the pooled clients and the refresh threads of the providers use
+        // the SDK, they have to be gone before it is shut down
+        aws_sdk_tcl_DrainSharedClients();
+        Aws::Vector<std::shared_ptr<aws_sdk_tcl_RefreshingCredentialsProvider>> providers;
+        Tcl_MutexLock(&aws_sdk_tcl_CredentialsProvidersMutex);
+        for (const auto &entry: aws_sdk_tcl_CredentialsProviders) {
+            if (auto provider = entry.second.lock()) {
+                providers.push_back(provider);
+            }
+        }
+        aws_sdk_tcl_CredentialsProviders.clear();
+        Tcl_MutexUnlock(&aws_sdk_tcl_CredentialsProvidersMutex);
+        for (const auto &provider: providers) {
+            provider->Stop();
+        }
+        providers.clear();
+        Tcl_MutexLock(&aws_sdk_tcl_ExecutorsMutex);
+        aws_sdk_tcl_Executors.clear();
+        Tcl_MutexUnlock(&aws_sdk_tcl_ExecutorsMutex);
+        Aws::ShutdownAPI(aws_sdk_tcl_options);
+    }
+    Tcl_MutexUnlock(&aws_sdk_tcl_InitMutex);
+}
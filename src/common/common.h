@@ -6,6 +6,8 @@
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/core/auth/AWSCredentials.h>
 #include <aws/core/client/ClientConfiguration.h>
+#include <aws/core/http/Scheme.h>
+#include <aws/core/client/AWSError.h>
 
 #define SetResult(str) Tcl_ResetResult(interp); \
                      Tcl_SetStringObj(Tcl_GetObjResult(interp), (str), -1)
@@ -13,6 +15,90 @@
 std::tuple<int, Aws::Client::ClientConfiguration, std::shared_ptr<Aws::Auth::AWSCredentialsProvider>>
         get_client_config_and_credentials_provider(Tcl_Interp *interp, Tcl_Obj *dict_ptr);
 
+int aws_sdk_tcl_DictGet(Tcl_Interp *interp, Tcl_Obj *dict_ptr, const char *key, Tcl_Obj **value_ptr);
+
 char *aws_sdk_strndup(const char *s, size_t n);
 
+// Sets the message of an SDK error as the result and a structured error
+// code that scripts can match on:
+//   AWS service exception_name http_status retryable request_id
+// e.g. {AWS S3 NoSuchKey 404 0 ABCD1234}. Errors of requests that never
+// got a response have the status -1 and, unless the SDK names them,
+// the exception name NetworkError. A module can pass the exception name
+// of the errors it maps from their type.
+template<typename ErrorType>
+int aws_sdk_tcl_SetErrorResult(Tcl_Interp *interp, const char *service, const Aws::Client::AWSError<ErrorType> &error,
+                               const char *exception_name = nullptr) {
+    int status = (int) error.GetResponseCode();
+    Aws::String name = exception_name ? exception_name : error.GetExceptionName();
+    if (name.empty()) {
+        name = status == (int) Aws::Http::HttpResponseCode::REQUEST_NOT_MADE ? "NetworkError" : "Unknown";
+    }
+    // e.g. the errors of HEAD requests come without a body and a message
+    const Aws::String &message = error.GetMessage().empty() ? name : error.GetMessage();
+    Tcl_SetObjResult(interp, Tcl_NewStringObj(message.c_str(), -1));
+
+    Tcl_Obj *codePtr = Tcl_NewListObj(0, nullptr);
+    Tcl_ListObjAppendElement(interp, codePtr, Tcl_NewStringObj("AWS", -1));
+    Tcl_ListObjAppendElement(interp, codePtr, Tcl_NewStringObj(service, -1));
+    Tcl_ListObjAppendElement(interp, codePtr, Tcl_NewStringObj(name.c_str(), -1));
+    Tcl_ListObjAppendElement(interp, codePtr, Tcl_NewIntObj(status));
+    Tcl_ListObjAppendElement(interp, codePtr, Tcl_NewBooleanObj(error.ShouldRetry()));
+    Tcl_ListObjAppendElement(interp, codePtr, Tcl_NewStringObj(error.GetRequestId().c_str(), -1));
+    Tcl_SetObjErrorCode(interp, codePtr);
+    return TCL_ERROR;
+}
+
+// The SDK runtime is shared by all the loaded modules, it is initialized
+// by the first call to aws_sdk_tcl_InitAPI and shut down when every call
+// has been matched by aws_sdk_tcl_ShutdownAPI.
+void aws_sdk_tcl_InitAPI();
+void aws_sdk_tcl_ShutdownAPI();
+
+// Creates the ::aws commands that are shared by all the modules, such as
+// ::aws::stats, every module creates them when it is loaded.
+void aws_sdk_tcl_CreateCommonCmds(Tcl_Interp *interp);
+
+// Clients created with -shared are pooled by service and configuration
+// and reference counted, every handle of a pooled client has a name of
+// its own, made unique by aws_sdk_tcl_NewSharedHandleId. The pool is
+// looked up with aws_sdk_tcl_FindSharedClient before a client is created
+// and added with aws_sdk_tcl_AddSharedClient, which returns the client
+// pooled by another thread meanwhile, if any, and destroys the new one.
+// The clients still pooled when the SDK is shut down are destroyed with
+// the delete_fn they were added with.
+int aws_sdk_tcl_GetSharedClientKey(Tcl_Interp *interp, const char *service, Tcl_Obj *dict_ptr, Aws::String &key);
+void *aws_sdk_tcl_FindSharedClient(const Aws::String &key);
+void *aws_sdk_tcl_AddSharedClient(const Aws::String &key, void *client, void (*delete_fn)(void *client));
+unsigned long aws_sdk_tcl_NewSharedHandleId();
+// Returns 1 when the caller has to destroy the client, i.e. when it was
+// not pooled or when its last reference has been released.
+int aws_sdk_tcl_ReleaseSharedClient(void *client);
+
+// Every handle owns a slot that is never freed but recycled with a new
+// generation, so that a slot cached in the internal representation of a
+// handle object, or in the clientData of its command, can be validated
+// without taking the lock of the name table of the module.
+typedef struct aws_sdk_tcl_slot_s aws_sdk_tcl_slot_t;
+aws_sdk_tcl_slot_t *aws_sdk_tcl_AllocSlot(const void *owner, void *item);
+void aws_sdk_tcl_FreeSlot(aws_sdk_tcl_slot_t *slot);
+void *aws_sdk_tcl_GetSlotItem(aws_sdk_tcl_slot_t *slot);
+void *aws_sdk_tcl_GetCachedItem(Tcl_Obj *objPtr, const void *owner);
+void *aws_sdk_tcl_SetCachedItem(Tcl_Obj *objPtr, aws_sdk_tcl_slot_t *slot);
+ClientData aws_sdk_tcl_NewHandleRef(aws_sdk_tcl_slot_t *slot, const char *name);
+void aws_sdk_tcl_FreeHandleRef(ClientData clientData);
+
+// The handle object kept in the clientData of a handle command, whose
+// internal representation already holds the slot of the handle, so that
+// a method resolves its client without touching objv[0]. The object stays
+// alive until the method returns, even if the method destroys the handle.
+class aws_sdk_tcl_HandleObj {
+public:
+    explicit aws_sdk_tcl_HandleObj(ClientData clientData);
+    ~aws_sdk_tcl_HandleObj();
+    aws_sdk_tcl_HandleObj(const aws_sdk_tcl_HandleObj &) = delete;
+    aws_sdk_tcl_HandleObj &operator=(const aws_sdk_tcl_HandleObj &) = delete;
+    Tcl_Obj *const objPtr;
+};
+
 #endif // COMMON_H
\ No newline at end of file